@@ -5,16 +5,70 @@
 #define CANVAS_HPP
 
 namespace canvas {
+/**
+ * @brief Smallest integer type holding a row of pixels
+ */
+template <bool small, bool medium>
+struct bits {
+    typedef unsigned long type;
+};
+
+template <bool medium>
+struct bits<true, medium> {
+    typedef byte type;
+};
+
+template <>
+struct bits<false, true> {
+    typedef unsigned int type;
+};
+
 /**
  * @class frame
- * @brief Emulate a canvas in screen
+ * @brief Emulate a canvas in screen, a row bitmask by line with first column in most significant bit
  *
  */
+template <const short width = 8, const short height = 8>
 class frame {
+    static_assert(width > 0 and width <= 32, "Frame width must be in 1 to 32");
+
+   public:
+    typedef typename bits<(width <= 8), (width <= 16)>::type row;
+
    private:
-    short pattern[8];
+    row pattern[height];
 
    public:
+    /**
+     * @brief Mask with all pixels in a row
+     *
+     * @return Full row
+     */
+    static constexpr row full() {  //
+        return row(~row(0)) >> (8 * sizeof(row) - width);
+    }
+
+    /**
+     * @brief Mask with a single pixel in a row
+     *
+     * @param column Horizontal position
+     * @return Pixel mask
+     */
+    static constexpr row mask(short column) {  //
+        return row(1) << (width - 1 - column);
+    }
+
+    /**
+     * @brief Verify if a pixel is inside frame
+     *
+     * @param line Vertical position
+     * @param column Horizontal position
+     * @return Inside
+     */
+    static constexpr bool inside(short line, short column) {  //
+        return line >= 0 and line < height and column >= 0 and column < width;
+    }
+
     /**
      * @brief Initialize frame with default values
      */
@@ -27,10 +81,10 @@ class frame {
      *
      * @param values Values array
      */
-    frame(const byte (&values)[8]) {
+    frame(const row (&values)[height]) {
         short index = short();
 
-        for (short &line : pattern) {
+        for (row &line : pattern) {
             line = values[index++];
         }
     }
@@ -39,8 +93,8 @@ class frame {
      * @brief Clear frame array to null value
      */
     void clear() {
-        for (short &line : pattern) {
-            line = short();
+        for (row &line : pattern) {
+            line = row();
         }
     }
 
@@ -52,14 +106,11 @@ class frame {
      * @return Value of pixel
      */
     bool get(short line, short column) const {
-        if (line < 0 or line > 7) {
-            return false;
-        }
-        if (column < 0 or column > 7) {
+        if (not inside(line, column)) {
             return false;
         }
 
-        return numerics::get(pattern[line], column);
+        return pattern[line] & mask(column);
     }
 
     /**
@@ -82,8 +133,16 @@ class frame {
      * @param column Horizontal position
      * @param value New Value to pixel
      */
-    void set(short line, short column, bool value) {  //
-        pattern[line] = numerics::set(pattern[line], column, value);
+    void set(short line, short column, bool value) {
+        if (not inside(line, column)) {
+            return;
+        }
+
+        if (value) {
+            pattern[line] |= mask(column);
+        } else {
+            pattern[line] &= ~mask(column);
+        }
     }
 
     /**
@@ -123,12 +182,58 @@ class frame {
         set<size>(points, value);
     }
 
+    /**
+     * @brief Compare two frames pixel by pixel
+     *
+     * @param other Other frame
+     * @return Value comparation
+     */
+    bool operator==(const frame &other) const {
+        for (short index = 0; index < height; index++) {
+            if (pattern[index] != other.pattern[index]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Light pixels lit in other frame
+     *
+     * @param other Other frame
+     * @return This frame
+     */
+    frame &operator|=(const frame &other) {
+        for (short index = 0; index < height; index++) {
+            pattern[index] |= other.pattern[index];
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Verify if two frames have some lit pixel in common
+     *
+     * @param other Other frame
+     * @return Overlap
+     */
+    bool overlap(const frame &other) const {
+        for (short index = 0; index < height; index++) {
+            if (pattern[index] & other.pattern[index]) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     /**
      * @brief Return pointer to begin of frame array
      *
      * @return Pointer to begin of frame array
      */
-    short *begin() const {  //
+    row *begin() const {  //
         return pattern;
     }
 
@@ -137,8 +242,8 @@ class frame {
      *
      * @return Pointer to end of frame array
      */
-    short *end() const {  //
-        return pattern + 8;
+    row *end() const {  //
+        return pattern + height;
     }
 
     /**
@@ -147,11 +252,110 @@ class frame {
      * @param index Array position
      * @return Array value
      */
-    short &operator[](short index) {  //
+    row &operator[](short index) {  //
+        return pattern[index];
+    }
+
+    /**
+     * @brief Implementation to [] operator to read values in frame array
+     *
+     * @param index Array position
+     * @return Array value
+     */
+    row operator[](short index) const {  //
         return pattern[index];
     }
 };
 
+/**
+ * @class planes
+ * @brief Emulate a grayscale canvas in screen, a frame by bit of pixel level
+ *
+ * Plane of bit k is shown for 2^k time slots in a cycle of 2^depth - 1 slots
+ */
+template <const short depth, const short width = 8, const short height = 8>
+class planes {
+   private:
+    frame<width, height> plane[depth];
+
+   public:
+    /**
+     * @brief Clear all planes
+     */
+    void clear() {
+        for (auto &bits : plane) {
+            bits.clear();
+        }
+    }
+
+    /**
+     * @brief Verify if all pixels are off
+     *
+     * @return Empty
+     */
+    bool empty() const {
+        for (auto &bits : plane) {
+            if (not(bits == frame<width, height>())) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Set pixel level
+     *
+     * @param point Pixel position
+     * @param level Level in 0 to 2^depth - 1
+     */
+    void set(const geometry::point &point, short level) {
+        for (short bit = 0; bit < depth; bit++) {
+            plane[bit].set(point, (level >> bit) & 1);
+        }
+    }
+
+    /**
+     * @brief Pixels lit at any level
+     *
+     * @return Frame of pixels lit in some plane
+     */
+    frame<width, height> lit() const {
+        frame<width, height> bits;
+
+        for (auto &other : plane) {
+            bits |= other;
+        }
+
+        return bits;
+    }
+
+    /**
+     * @brief Amount of time slots in a cycle
+     *
+     * @return Slots
+     */
+    static constexpr short slots() {  //
+        return (1 << depth) - 1;
+    }
+
+    /**
+     * @brief Frame shown in a time slot
+     *
+     * @param slot Time slot in cycle
+     * @return Plane shown
+     */
+    const frame<width, height> &slice(short slot) const {
+        short bit = 0;
+
+        while ((2 << bit) - 1 <= slot) {
+            bit++;
+        }
+
+        return plane[bit];
+    }
+};
+
 /**
  * @class layer
  * @brief Emulate a canvas in display
@@ -230,7 +434,7 @@ class layer {
      * @return Pointer to end of layer array
      */
     short *end() const {  //
-        return pattern + 8;
+        return pattern + 4;
     }
 
     /**
@@ -243,6 +447,84 @@ class layer {
         return pattern[index];
     }
 };
+
+/**
+ * @class counter
+ * @brief Decimal counter stored as packed BCD, counting and showing without division
+ *
+ */
+template <const short digits>
+class counter {
+    static_assert(digits > 0 and digits <= 4, "Counter holds 1 to 4 digits");
+
+   private:
+    unsigned short value;
+
+   public:
+    /**
+     * @brief Initialize counter
+     *
+     * @param start Initial value, in BCD
+     */
+    counter(unsigned short start = 0) : value(start) {}
+
+    /**
+     * @brief Increment counter, saturating in all digits 9
+     *
+     * @return This counter
+     */
+    counter &operator++() {
+        unsigned short next = value;
+
+        for (short index = 0; index < digits; index++) {
+            short shift = 4 * index;
+
+            if (((next >> shift) & 0xF) < 9) {
+                value = next + (1 << shift);
+                return *this;
+            }
+
+            next &= ~(0xF << shift);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Packed BCD value, ordered as the decimal number
+     *
+     * @return BCD value
+     */
+    unsigned short get() const {  //
+        return value;
+    }
+
+    /**
+     * @brief Get a digit
+     *
+     * @param index Digit position, from most significant
+     * @return Digit
+     */
+    short digit(short index) const {  //
+        return (value >> (4 * (digits - 1 - index))) & 0xF;
+    }
+
+    /**
+     * @brief Write digits in layer, only the ones that changed since layer is kept between frames
+     *
+     * @param segments Layer
+     * @param offset Position of most significant digit in layer
+     */
+    void write(layer &segments, short offset) const {
+        for (short index = 0; index < digits; index++) {
+            short value = digit(index);
+
+            if (segments[offset + index] != value) {
+                segments.set(offset + index, value);
+            }
+        }
+    }
+};
 }  // namespace canvas
 
 #endif
@@ -5,11 +5,151 @@
 #define DEVICES_HPP
 
 namespace devices {
+unsigned long touched{};  // Moment of the last button edge or knob change
+unsigned long pressed{};  // Moment of the last button press edge
+unsigned long dialed{};   // Moment of the last knob move beyond noise
+
+/**
+ * @class pin
+ * @brief Digital pin bound at compile time, accessing port registers directly in Arduino Uno (ATmega328P)
+ *
+ * Pins 0 to 7 are in port D, 8 to 13 in port B and A0 to A5 in port C, so each access is a single instruction.
+ * Other targets (as a host simulation) fall back to Arduino calls.
+ */
+template <const byte number>
+class pin {
+#if defined(__AVR_ATmega328P__)
+    static_assert(number < 20, "Pin must be in 0 to 19");
+
+    /**
+     * @brief Data direction register
+     *
+     * @return Register
+     */
+    static volatile byte &direction() {  //
+        return number < 8 ? DDRD : number < 14 ? DDRB : DDRC;
+    }
+
+    /**
+     * @brief Output register
+     *
+     * @return Register
+     */
+    static volatile byte &port() {  //
+        return number < 8 ? PORTD : number < 14 ? PORTB : PORTC;
+    }
+
+    /**
+     * @brief Input register
+     *
+     * @return Register
+     */
+    static volatile byte &state() {  //
+        return number < 8 ? PIND : number < 14 ? PINB : PINC;
+    }
+
+    /**
+     * @brief Bit of pin in its registers
+     *
+     * @return Bit mask
+     */
+    static constexpr byte mask() {  //
+        return 1 << (number < 8 ? number : number < 14 ? number - 8 : number - 14);
+    }
+
+   public:
+    /**
+     * @brief Drive pin as output
+     */
+    static void output() {  //
+        direction() |= mask();
+    }
+
+    /**
+     * @brief Release pin as input, without pull-up
+     */
+    static void input() {
+        direction() &= ~mask();
+        port() &= ~mask();
+    }
+
+    /**
+     * @brief Release pin as input, keeping output register (a low one leaves an open drain line floating)
+     */
+    static void release() {  //
+        direction() &= ~mask();
+    }
+
+    /**
+     * @brief Write pin level
+     *
+     * @param value Level
+     */
+    static void write(bool value) {
+        if (value) {
+            port() |= mask();
+        } else {
+            port() &= ~mask();
+        }
+    }
+
+    /**
+     * @brief Read pin level
+     *
+     * @return Level
+     */
+    static bool read() {  //
+        return state() & mask();
+    }
+#else
+   public:
+    /**
+     * @brief Drive pin as output
+     */
+    static void output() {  //
+        pinMode(number, OUTPUT);
+    }
+
+    /**
+     * @brief Release pin as input, without pull-up
+     */
+    static void input() {  //
+        pinMode(number, INPUT);
+    }
+
+    /**
+     * @brief Release pin as input, keeping output register (a low one leaves an open drain line floating)
+     */
+    static void release() {  //
+        pinMode(number, INPUT);
+    }
+
+    /**
+     * @brief Write pin level
+     *
+     * @param value Level
+     */
+    static void write(bool value) {  //
+        digitalWrite(number, value);
+    }
+
+    /**
+     * @brief Read pin level
+     *
+     * @return Level
+     */
+    static bool read() {  //
+        return digitalRead(number);
+    }
+#endif
+};
+
 /**
  * @class screen
- * @brief Emulate a 8x8 led screen (MAX7219)
+ * @brief Emulate a chain of 8x8 led screens (MAX7219), first module wired to Arduino
  *
  */
+template <const short modules = 1>
 class screen {
    private:
     const int input;
@@ -23,6 +163,9 @@ class screen {
     const byte shutdown{0xC};
     const byte test{0xF};
 
+    byte rows[modules][8]{};  // Rows recorded in each module
+    byte level{};             // Intensity recorded in modules
+
    public:
     /**
      * @brief Initialize screen
@@ -42,49 +185,88 @@ class screen {
         control(shutdown, 0x01);   // shutdown
         control(intensity, 0x08);  // intensity
 
+        level = 0x08;
+
         clear();
     }
 
     /**
-     * @brief Record data in an address in screen
+     * @brief Record same data in an address in all modules, in one load pulse
      *
      * @param adress Address in screen
      * @param data Data to be recorded
      */
     void control(byte adress, byte data) const {
         digitalWrite(load, false);
-        shiftOut(input, clock, MSBFIRST, adress);
-        shiftOut(input, clock, MSBFIRST, data);
+
+        for (short module = 0; module < modules; module++) {
+            shiftOut(input, clock, MSBFIRST, adress);
+            shiftOut(input, clock, MSBFIRST, data);
+        }
+
         digitalWrite(load, true);
     }
 
     /**
-     * @brief Render a frame in screen
+     * @brief Record a row in all modules, in one load pulse
      *
-     * @param pattern Frame to be rendered
+     * @param index Row index
      */
-    void render(const canvas::frame &pattern) const {
-        short index = short();
+    void line(short index) const {
+        digitalWrite(load, false);
 
-        for (const short &line : pattern) {
-            control(++index, numerics::reverse(line));
+        for (short module = modules - 1; module >= 0; module--) {
+            shiftOut(input, clock, MSBFIRST, index + 1);
+            shiftOut(input, clock, MSBFIRST, rows[module][index]);
         }
+
+        digitalWrite(load, true);
     }
 
     /**
-     * @brief Render a frame in screen
+     * @brief Render a frame across modules, sending only the rows that changed
      *
-     * @param pattern Frame to be rendered
+     * @param pattern Frame to be rendered, first module on the leftmost columns
      */
-    void render(const canvas::frame &&pattern) const {  //
+    void render(const canvas::frame<8 * modules, 8> &pattern) {
+        for (short index = 0; index < 8; index++) {
+            bool changed = false;
+
+            for (short module = 0; module < modules; module++) {
+                byte data = numerics::reverse(pattern[index] >> (8 * (modules - 1 - module)));
+
+                if (rows[module][index] != data) {
+                    rows[module][index] = data;
+                    changed = true;
+                }
+            }
+
+            if (changed) {
+                line(index);
+            }
+        }
+    }
+
+    /**
+     * @brief Render a frame across modules, sending only the rows that changed
+     *
+     * @param pattern Frame to be rendered, first module on the leftmost columns
+     */
+    void render(const canvas::frame<8 * modules, 8> &&pattern) {  //
         render(pattern);
     }
 
     /**
      * @brief Clear screen
      */
-    void clear() const {  //
-        render(canvas::frame());
+    void clear() {
+        for (short index = 0; index < 8; index++) {
+            for (short module = 0; module < modules; module++) {
+                rows[module][index] = 0;
+            }
+
+            line(index);
+        }
     }
 
     /**
@@ -92,22 +274,30 @@ class screen {
      *
      * @param bright Bright value
      */
-    void brightness(byte bright) const {
+    void brightness(byte bright) {
         bright = map(bright, 0, 100, 1, 15);
 
+        if (bright == level) {
+            return;
+        }
+
+        level = bright;
+
         control(intensity, bright);
     }
 };
 
 /**
  * @class display
- * @brief Emulate a 4-digit 7-segment display (TM1637)
+ * @brief Emulate a 4-digit 7-segment display (TM1637), lines are open drain (driven low or released high)
  *
  */
+template <const byte input, const byte clock>
 class display {
    private:
-    const int input;
-    const int clock;
+    typedef pin<input> dio;
+    typedef pin<clock> clk;
+
     const int time;
 
     const int first{0x40};
@@ -116,20 +306,22 @@ class display {
 
     bool dots{false};
 
+    byte digits[4]{};  // Segments recorded in display
+    byte level{};      // Brightness recorded in display
+    bool valid{false};
+
    public:
     /**
      * @brief Initialize display
      *
-     * @param input Input pin
-     * @param clock Clock pin
-     * @param time Time pin
+     * @param time Bit time in microseconds
      */
-    display(int input, int clock, int time) : input(input), clock(clock), time(time) {
-        pinMode(input, INPUT);
-        pinMode(clock, INPUT);
+    display(int time) : time(time) {
+        dio::input();
+        clk::input();
 
-        digitalWrite(input, LOW);
-        digitalWrite(clock, LOW);
+        dio::write(LOW);
+        clk::write(LOW);
     }
 
     /**
@@ -143,7 +335,7 @@ class display {
      * @brief Start to writing data in display
      */
     void start() const {
-        pinMode(input, OUTPUT);
+        dio::output();
         wait();
     }
 
@@ -151,11 +343,11 @@ class display {
      * @brief Stop to writing data in display
      */
     void stop() const {
-        pinMode(input, OUTPUT);
+        dio::output();
         wait();
-        pinMode(clock, INPUT);
+        clk::release();
         wait();
-        pinMode(input, INPUT);
+        dio::release();
         wait();
     }
 
@@ -168,36 +360,36 @@ class display {
         byte condition = 8;
 
         while (condition--) {
-            pinMode(clock, OUTPUT);
+            clk::output();
             wait();
 
             if (data & 1)
-                pinMode(input, INPUT);
+                dio::release();
             else
-                pinMode(input, OUTPUT);
+                dio::output();
 
             wait();
-            pinMode(clock, INPUT);
+            clk::release();
             wait();
 
             data = data >> 1;
         }
 
-        pinMode(clock, OUTPUT);
-        pinMode(input, INPUT);
+        clk::output();
+        dio::release();
         wait();
 
-        pinMode(clock, INPUT);
+        clk::release();
         wait();
 
-        bool value = digitalRead(input);
+        bool value = dio::read();
 
         if (value) {
-            pinMode(input, OUTPUT);
+            dio::output();
         }
 
         wait();
-        pinMode(clock, OUTPUT);
+        clk::output();
         wait();
     }
 
@@ -206,13 +398,9 @@ class display {
      *
      * @param segments Layer to be rendered
      */
-    void render(const canvas::layer &segments) const {
-        start();
-        write(first);
-        stop();
-
-        start();
-        write(second);
+    void render(const canvas::layer &segments) {
+        bool changed = not valid;
+        short index = short();
 
         for (short &segment : segments) {
             byte data = numerics::encode(segment);
@@ -221,6 +409,28 @@ class display {
                 data = data | (1 << 7);
             }
 
+            if (digits[index] != data) {
+                digits[index] = data;
+                changed = true;
+            }
+
+            index++;
+        }
+
+        if (not changed) {
+            return;
+        }
+
+        valid = true;
+
+        start();
+        write(first);
+        stop();
+
+        start();
+        write(second);
+
+        for (byte &data : digits) {
             write(data);
         }
 
@@ -232,14 +442,16 @@ class display {
      *
      * @param segments Layer to be rendered
      */
-    void render(const canvas::layer &&segments) const {  //
+    void render(const canvas::layer &&segments) {  //
         render(segments);
     }
 
     /**
      * @brief Clear display
      */
-    void clear() const {  //
+    void clear() {
+        valid = false;
+
         render(canvas::layer());
     }
 
@@ -258,7 +470,7 @@ class display {
      * @param bright Bright
      * @param enable Enable
      */
-    void brightness(byte bright, bool enable = true) const {
+    void brightness(byte bright, bool enable = true) {
         bright = map(bright, 0, 100, 0, 7);
 
         if (enable) {
@@ -267,6 +479,12 @@ class display {
             bright = ((bright & 0b0111) | 0b0000) & 0b1111;
         }
 
+        if (valid and bright == level) {
+            return;
+        }
+
+        level = bright;
+
         start();
         write(third + bright);
         stop();
@@ -282,7 +500,11 @@ class knob {
    private:
     const int input;
 
-    int count;
+    const short noise{8};
+
+    short last;        // Raw value where knob settled, it moves only beyond noise (or to an end)
+    short driven{-1};  // Raw value set by a virtual input, replacing the pin
+    bool moved{true};  // Turned since anchored
 
    public:
     /**
@@ -293,11 +515,11 @@ class knob {
     knob(int input) : input(input) {
         pinMode(input, INPUT);
 
-        count = 0;
+        last = 0;
     }
 
     /**
-     * @brief Read knob position
+     * @brief Read knob position where it settled, so jitter within noise never changes it
      *
      * @param inferior Inferior range
      * @param superior Superior range
@@ -306,7 +528,58 @@ class knob {
     int read(short inferior = 0, short superior = 100) {
         short value = analogRead(input);
 
-        return map(value, 0, 1023, inferior, superior);
+        bool end = value != last and (value == 0 or value == 1023);
+
+        if (abs(value - last) > noise or end) {
+            last = value;
+            touched = micros();
+            dialed = touched;
+            moved = true;
+        }
+
+        return map(driven >= 0 ? driven : last, 0, 1023, inferior, superior);
+    }
+
+    /**
+     * @brief Anchor knob at its position, so a restored setting is kept until knob is turned away from it
+     */
+    void anchor() {
+        last = analogRead(input);
+        moved = false;
+    }
+
+    /**
+     * @brief Verify if knob was turned since anchored (a knob never anchored is always turned)
+     *
+     * @return Turned
+     */
+    bool turned() const {  //
+        return moved;
+    }
+
+    /**
+     * @brief Drive knob as a virtual input, so reads in same range return position (pin is still sampled)
+     *
+     * @param position Position relative range
+     * @param inferior Inferior range
+     * @param superior Superior range
+     */
+    void drive(short position, short inferior = 0, short superior = 100) {
+        long range = superior - inferior;
+
+        if (range == 0) {
+            driven = 0;
+            return;
+        }
+
+        driven = ((position - inferior) * 1023L + range - 1) / range;
+    }
+
+    /**
+     * @brief Release virtual input, reads come back from pin
+     */
+    void release() {  //
+        driven = -1;
     }
 };
 
@@ -315,71 +588,164 @@ class knob {
  * @brief Push Button
  *
  */
+template <const byte input>
 class button {
    private:
-    const int input;
+    typedef pin<input> line;
+
+    bool last{false};
+    bool held{false};  // Pressed since last read
 
    public:
     /**
      * @brief Initialize button
+     */
+    button() {  //
+        line::input();
+    }
+
+    /**
+     * @brief Sample button and hold a press until it is read
+     */
+    void poll() {
+        bool value = line::read();
+
+        if (value != last) {
+            last = value;
+            touched = micros();
+
+            if (value) {
+                pressed = touched;
+            }
+        }
+
+        held = held or value;
+    }
+
+    /**
+     * @brief Press button as a virtual input, held until it is read (no input edge is stamped)
+     */
+    void press() {  //
+        held = true;
+    }
+
+    /**
+     * @brief State button in last sample, without taking a held press
      *
-     * @param input Input pin
+     * @return Button state
      */
-    button(int input) : input(input) {  //
-        pinMode(input, INPUT);
+    bool state() const {  //
+        return last;
     }
 
     /**
      * @brief Read state button
      *
-     * @return Button state (pressed or unpressed)
+     * @return Button state (pressed now or since last read)
      */
-    bool read() const {
-        bool value = digitalRead(input);
+    bool read() {
+        poll();
+
+        bool value = held;
+
+        held = false;
 
         return value;
     }
 };
 
+/**
+ * @brief Note in a melody, stored in flash (a null duration ends melody)
+ */
+struct note {
+    unsigned short frequency;  // Frequency (zero to a rest)
+    unsigned short duration;   // Duration in milliseconds
+};
+
 /**
  * @class buzzer
- * @brief Buzzer (it does not really used in project)
+ * @brief Buzzer playing melodies in background
  *
  */
+template <const byte input>
 class buzzer {
    private:
-    const int input;
+    const note *melody{nullptr};
+
+    unsigned long since{};
+    unsigned short duration{};
 
    public:
     /**
      * @brief Initialize buzzer
-     *
-     * @param input Input pin
      */
-    buzzer(int input) : input(input) {  //
-        pinMode(input, OUTPUT);
+    buzzer() {  //
+        pin<input>::output();
     }
 
     /**
-     * @brief Play a square wave in a frequency by a time
+     * @brief Play a square wave in a frequency by a time, without waiting it
      *
      * @param frequency Frequency
-     * @param duration Duration
+     * @param duration Duration (zero to play until stop)
      */
     void start(int frequency, int duration = 0) {
-        tone(input, frequency);
-
         if (duration) {
-            delay(duration);
+            tone(input, frequency, duration);
+        } else {
+            tone(input, frequency);
         }
     }
 
     /**
      * @brief Stop playing
      */
-    void stop() {  //
+    void stop() {
+        melody = nullptr;
+
         noTone(input);
     }
+
+    /**
+     * @brief Start playing a melody from flash, replacing the current one
+     *
+     * @param notes Notes in flash
+     */
+    void play(const note *notes) {
+        melody = notes;
+        duration = 0;
+    }
+
+    /**
+     * @brief Advance melody to next note when current one is over
+     */
+    void tick() {
+        if (melody == nullptr) {
+            return;
+        }
+
+        if (millis() - since < duration) {
+            return;
+        }
+
+        unsigned short frequency = pgm_read_word(&melody->frequency);
+
+        since = millis();
+        duration = pgm_read_word(&melody->duration);
+
+        if (duration == 0) {
+            stop();
+            return;
+        }
+
+        if (frequency) {
+            tone(input, frequency);
+        } else {
+            noTone(input);
+        }
+
+        melody++;
+    }
 };
 }  // namespace devices
 
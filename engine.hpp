@@ -1,7 +1,10 @@
-#include "invaders.hpp"
-#include "pong.hpp"
-#include "snake.hpp"
-#include "tetris.hpp"
+#include "games.hpp"
+#include "monitor.hpp"
+#include "profile.hpp"
+#include "scheduler.hpp"
+#include "storage.hpp"
+#include "telemetry.hpp"
+#include "trace.hpp"
 
 #include "things.hpp"
 #include "utils.hpp"
@@ -11,77 +14,104 @@
 
 namespace engine {
 int choice = 0;
+short level = 0;
 
-void (*started[])(void) = {
-    pong::start,     //
-    snake::start,    //
-    tetris::start,   //
-    invaders::start  //
-};
+bool selecting = true;
+bool playing = false;
+bool paused = false;
+bool armed = true;
+bool gripped = false;
+bool autoplay = false;
 
-void (*updated[])(int) = {
-    pong::update,     //
-    snake::update,    //
-    tetris::update,   //
-    invaders::update  //
-};
+bool suspended[games::count] = {};
 
-bool (*verified[])(void) = {
-    pong::verify,     //
-    snake::verify,    //
-    tetris::verify,   //
-    invaders::verify  //
-};
-
-canvas::frame image[4] = {
-    pong::image,     //
-    snake::image,    //
-    tetris::image,   //
-    invaders::image  //
-};
+unsigned long moment = 0;
+short slice = 0;
+unsigned long since = 0;
+unsigned long span = 0;
+unsigned long grip = 0;
+unsigned long watched = 0;
+unsigned long shown = 0;
 
 /**
- * @brief Change screen and display brightness
+ * @brief Change screen and display brightness, restored brightness is kept until knob is turned
  */
 void brightness() {
     int bright = things::bright.read(0, 100);
 
+    if (not things::bright.turned()) {
+        bright = storage::current.bright;
+    }
+
     things::screen.brightness(bright);
     things::display.brightness(bright);
+
+    storage::settings(bright, level);
 }
 
 /**
- * @brief Read level game in knob
+ * @brief Read level game in knob, restored level is kept until knob is turned
  *
  * @return Level game
  */
 int difficulty() {
     short level = things::level.read(0, 3);
 
+    if (not things::level.turned()) {
+        level = min(storage::current.level, 3);
+    }
+
     return level;
 }
 
 /**
- * @brief Render in screen and display
+ * @brief Render in screen the frame with the shade plane of current time slot
+ */
+void screen() {
+    profile::begin(profile::screening);
+
+    if (things::shade.empty()) {
+        things::screen.render(things::frame);
+    } else {
+        canvas::frame<things::width, things::height> image = things::frame;
+
+        image |= things::shade.slice(slice);
+
+        things::screen.render(image);
+    }
+
+    slice = (slice + 1) % things::shade.slots();
+
+    profile::end(profile::screening);
+    profile::render(things::frame, things::shade);
+}
+
+/**
+ * @brief Render in display
  */
-void render() {
-    things::screen.render(things::frame);
+void display() {
+    profile::begin(profile::displaying);
+
     things::display.render(things::layer);
+
+    profile::end(profile::displaying);
+    profile::frame(micros() - moment);
+    profile::report(choice, level);
 }
 
 /**
- * @brief Clear screen and display
+ * @brief Clear screen, display layer is kept as selector and games write all four digits each frame
  */
 void clear() {
     things::frame.clear();
-    things::layer.clear();
+    things::shade.clear();
 }
 
 /**
  * @brief Start game
  */
 void start() {  //
-    started[choice]();
+    games::get(choice).start();
 }
 
 /**
@@ -90,9 +120,11 @@ void start() {  //
 void update() {
     brightness();
 
-    short level = difficulty();
+    level = difficulty();
 
-    updated[choice](level);
+    profile::begin(profile::updating);
+    games::get(choice).update(level);
+    profile::end(profile::updating);
 }
 
 /**
@@ -101,7 +133,67 @@ void update() {
  * @return Defeat
  */
 bool verify() {  //
-    return verified[choice]();
+    return games::get(choice).verify();
+}
+
+/**
+ * @brief Hold game for a while without blocking other tasks
+ *
+ * @param duration Duration in milliseconds
+ */
+void pause(unsigned long duration) {
+    paused = true;
+
+    since = millis();
+    span = duration;
+}
+
+/**
+ * @brief Start attract mode after a while without inputs, games are played by their automatic players
+ *
+ * Each game is shown until defeat or for the same while, then next game is played. A suspended game is kept,
+ * so attract mode waits until it is resumed
+ *
+ * @return Attract mode started
+ */
+bool attract() {
+    if (micros() - devices::touched < things::idle * 1000) {
+        return false;
+    }
+
+    for (bool hold : suspended) {
+        if (hold) {
+            return false;
+        }
+    }
+
+    autoplay = true;
+    watched = devices::touched;
+
+    selecting = false;
+
+    pause(1000);
+
+    return true;
+}
+
+/**
+ * @brief Leave attract mode on any input and return to selector
+ */
+void wake() {
+    autoplay = false;
+
+    for (short index = 0; index < games::count; index++) {
+        games::get(index).reset();
+    }
+
+    things::first.release();
+    things::second.release();
+
+    selecting = true;
+    playing = false;
+    paused = false;
+    armed = false;
 }
 
 /**
@@ -110,58 +202,239 @@ bool verify() {  //
 void selector() {
     clear();
 
-    while (true) {
-        choice = things::first.read(0, 3);
+    if (attract()) {
+        return;
+    }
 
-        for (int index = 0; index < 8; index++) {
-            things::frame[index] = image[choice][index];
-        }
+    choice = things::first.read(0, games::count - 1);
+
+    for (int index = 0; index < 8; index++) {
+        things::frame[index] = games::image(choice, index);
+        things::frame[index] <<= things::width - 8;
+    }
 
-        bool stop = bool(things::left.read() || things::right.read() || things::top.read() || things::bottom.read());
+    canvas::counter<4> best(storage::best(games::get(choice).id));
 
-        if (stop) {
-            for (int index = 0; index < 4; index++) {
-                things::layer.set(index, 10);
-            }
+    best.write(things::layer, 0);
 
-            brightness();
-            render();
+    things::display.separator(suspended[choice]);
 
-            delay(1000);
-            break;
+    bool stop = bool(things::left.read() || things::right.read() || things::top.read() || things::bottom.read());
+
+    if (not armed) {
+        armed = not stop;
+        return;
+    }
+
+    if (stop) {
+        for (int index = 0; index < 4; index++) {
+            things::layer.set(index, 10);
         }
 
-        render();
+        brightness();
+
+        selecting = false;
+
+        pause(1000);
     }
 }
 
 /**
- * @brief Initialize game
+ * @brief Suspend game and return to selector, game state is kept to resume it later
  */
-void init() {
-    numerics::seed();
+void suspend() {
+    suspended[choice] = true;
 
-    Serial.begin(9600);
+    selecting = true;
+    playing = false;
+    paused = false;
+    armed = false;
+}
 
-    selector();
-    start();
+/**
+ * @brief Poll inputs, so short presses are held until the next game tick
+ */
+void sample() {
+    things::left.poll();
+    things::right.poll();
+    things::top.poll();
+    things::bottom.poll();
+
+    bool all = things::left.state() and things::right.state() and things::top.state() and things::bottom.state();
+
+    if (not all) {
+        gripped = false;
+    } else if (not gripped) {
+        gripped = true;
+        grip = millis();
+    } else if (playing and millis() - grip >= 1000) {
+        gripped = false;
+
+        suspend();
+    }
+
+    if (not things::profile) {
+        return;
+    }
+
+    things::first.read();
+    things::second.read();
 }
 
 /**
- * @brief Run
+ * @brief Write staged scores and settings in EEPROM
  */
-void run() {
+void save() {  //
+    storage::tick();
+}
+
+/**
+ * @brief Report free memory, stack high water mark and interrupts share
+ */
+void watch() {  //
+    monitor::report();
+}
+
+/**
+ * @brief Names of tasks in trace, in order of tasks
+ */
+const char names[] PROGMEM = "sample\0sound\0screen\0tick\0display\0stream\0save\0watch\0record\0";
+
+/**
+ * @brief Drain trace events over Serial
+ */
+void record() {  //
+    trace::dump(names);
+}
+
+/**
+ * @brief Stream rendered frame and layer over Serial
+ */
+void stream() {  //
+    telemetry::send(things::frame, things::shade, things::layer);
+}
+
+/**
+ * @brief Advance melody in buzzer
+ */
+void sound() {  //
+    things::buzzer.tick();
+}
+
+/**
+ * @brief Advance selector or game by a frame
+ */
+void tick() {
+    moment = micros();
+
+    if (autoplay and devices::touched != watched) {
+        wake();
+    }
+
+    if (paused) {
+        if (millis() - since < span) {
+            return;
+        }
+
+        paused = false;
+
+        things::display.separator(false);
+
+        if (suspended[choice]) {
+            suspended[choice] = false;
+        } else {
+            start();
+        }
+
+        playing = true;
+        shown = millis();
+
+        return;
+    }
+
+    if (selecting) {
+        selector();
+        return;
+    }
+
+    if (gripped and not autoplay) {
+        things::left.read();
+        things::right.read();
+        things::top.read();
+        things::bottom.read();
+
+        return;
+    }
+
     clear();
+
+    if (autoplay) {
+        games::get(choice).pilot();
+    }
+
     update();
-    render();
 
     if (verify()) {
-        delay(500);
+        trace::mark(trace::defeat);
+
+        if (autoplay) {
+            choice = (choice + 1) % games::count;
+        } else {
+            storage::score(games::get(choice).id, games::get(choice).result());
+        }
 
-        start();
+        pause(500);
+    } else if (autoplay and millis() - shown >= things::idle) {
+        choice = (choice + 1) % games::count;
+
+        pause(500);
     }
+}
+
+scheduler::task tasks[] = {
+    scheduler::task(sample, 2, false),         //
+    scheduler::task(sound, 5),                 //
+    scheduler::task(screen, things::slot),     //
+    scheduler::task(tick, things::period),     //
+    scheduler::task(display, things::period),  //
+    scheduler::task(stream, things::period),   //
+    scheduler::task(save, 10),                 //
+    scheduler::task(watch, 1000),              //
+    scheduler::task(record, 2, false),         //
+};
+
+/**
+ * @brief Initialize game
+ */
+void init() {
+    monitor::paint();
 
-    delay(things::period);
+    numerics::seed();
+
+    Serial.begin(things::baud);
+
+    if (storage::load()) {
+        things::level.anchor();
+        things::bright.anchor();
+    }
+
+    level = difficulty();
+
+    brightness();
+
+    things::first.read();
+    things::second.read();
+
+    clear();
+}
+
+/**
+ * @brief Run
+ */
+void run() {
+    if (scheduler::dispatch(tasks) < 0) {
+        monitor::idle();
+    }
 }
 }  // namespace engine
 
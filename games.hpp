@@ -0,0 +1,119 @@
+#ifndef GAMES_PONG
+#define GAMES_PONG 1
+#endif
+
+#ifndef GAMES_SNAKE
+#define GAMES_SNAKE 1
+#endif
+
+#ifndef GAMES_TETRIS
+#define GAMES_TETRIS 1
+#endif
+
+#ifndef GAMES_INVADERS
+#define GAMES_INVADERS 1
+#endif
+
+#if GAMES_PONG
+#include "lockstep.hpp"
+#endif
+
+#if GAMES_SNAKE
+#include "snake.hpp"
+#endif
+
+#if GAMES_TETRIS
+#include "tetris.hpp"
+#endif
+
+#if GAMES_INVADERS
+#include "invaders.hpp"
+#endif
+
+#ifndef GAMES_HPP
+#define GAMES_HPP
+
+namespace games {
+/**
+ * @brief Game entry points and selector image, stored in flash
+ */
+struct descriptor {
+    byte id;  // Stable identifier, used to save scores
+
+    void (*start)(void);
+    void (*update)(int);
+    bool (*verify)(void);
+    unsigned short (*result)(void);
+    void (*pilot)(void);
+    void (*reset)(void);
+
+    const byte *image;
+};
+
+#if GAMES_PONG
+#define GAMES_PONG_ENTRY {0, lockstep::start, lockstep::update, lockstep::verify, pong::result, pong::pilot, pong::reset, pong::image},
+#else
+#define GAMES_PONG_ENTRY
+#endif
+
+#if GAMES_SNAKE
+#define GAMES_SNAKE_ENTRY {1, snake::start, snake::update, snake::verify, snake::result, snake::pilot, snake::reset, snake::image},
+#else
+#define GAMES_SNAKE_ENTRY
+#endif
+
+#if GAMES_TETRIS
+#define GAMES_TETRIS_ENTRY {2, tetris::start, tetris::update, tetris::verify, tetris::result, tetris::pilot, tetris::reset, tetris::image},
+#else
+#define GAMES_TETRIS_ENTRY
+#endif
+
+#if GAMES_INVADERS
+#define GAMES_INVADERS_ENTRY {3, invaders::start, invaders::update, invaders::verify, invaders::result, invaders::pilot, invaders::reset, invaders::image},
+#else
+#define GAMES_INVADERS_ENTRY
+#endif
+
+constexpr descriptor table[] PROGMEM = {GAMES_PONG_ENTRY GAMES_SNAKE_ENTRY GAMES_TETRIS_ENTRY GAMES_INVADERS_ENTRY};
+
+/**
+ * @brief Same entries out of flash, only folded at compile time (never read at run time, so never stored)
+ */
+constexpr descriptor entries[] = {GAMES_PONG_ENTRY GAMES_SNAKE_ENTRY GAMES_TETRIS_ENTRY GAMES_INVADERS_ENTRY};
+
+const short count = sizeof(table) / sizeof(descriptor);
+
+/**
+ * @brief Get descriptor of a game, read from flash, or folded at compile time when a single game is built
+ *
+ * With a single game, its functions are called statically, so the compiler can inline them. Table in flash is
+ * never read with a normal load, which would read RAM at same address
+ *
+ * @param index Game position in table
+ * @return Descriptor
+ */
+descriptor get(short index) {
+    if (count == 1) {
+        return entries[0];
+    }
+
+    descriptor game;
+
+    memcpy_P(&game, &table[index], sizeof(descriptor));
+
+    return game;
+}
+
+/**
+ * @brief Read a line of selector image of a game
+ *
+ * @param index Game position in table
+ * @param line Line in image
+ * @return Line value
+ */
+byte image(short index, short line) {  //
+    return pgm_read_byte(get(index).image + line);
+}
+}  // namespace games
+
+#endif
@@ -1,61 +1,82 @@
 #include "geometry.hpp"
 #include "things.hpp"
+#include "trace.hpp"
 #include "utils.hpp"
 
 #ifndef INVADERS_HPP
 #define INVADERS_HPP
 
 namespace invaders {
+typedef canvas::frame<things::width, things::height> board;
+
+const short capacity = 4;
+
 geometry::object<4> ship;
-geometry::object<4> enemy;
 
-geometry::point bullet;
+board wave;
+
+short lines[capacity];
+short columns[capacity];
+byte alive{};
 
 short position{};
+bool pulled{};  // Trigger held in last tick, so holding it fires once
 
-short deads{};
-short points{};
+canvas::counter<2> deads;
+canvas::counter<2> points;
 short level{};
 
 short steps{};
 short count{};
+short descents{};
 
-bool shot{};
+/**
+ * @brief Bytes of game state in RAM, listed along with globals above
+ */
+const short footprint = sizeof(ship) + sizeof(wave) + sizeof(lines) + sizeof(columns) + sizeof(alive) +
+                        sizeof(position) + sizeof(pulled) + sizeof(deads) + sizeof(points) + sizeof(level) +
+                        sizeof(steps) + sizeof(count) + sizeof(descents);
 
 void start();
 void read();
-int evade();
+void fire();
+void spawn();
+void collide();
 void draw();
 void repos();
 bool verify();
+unsigned short result();
+void pilot();
+void reset();
 void update(int);
 
-canvas::frame image({0b11111111, 0b10000001, 0b10011101, 0b10001001, 0b10010001, 0b10111001, 0b10000001, 0b11111111});
+const devices::note kill[] PROGMEM = {{1568, 40}, {0, 20}, {1175, 60}, {0, 0}};
+
+const byte image[8] PROGMEM = {0b11111111, 0b10000001, 0b10011101, 0b10001001, 0b10010001, 0b10111001, 0b10000001, 0b11111111};
+
+const byte formations[] PROGMEM = {0b00011000, 0b00100100, 0b01000010, 0b01011010, 0b00101010, 0b00111100};
+
+const short kinds = sizeof(formations) / sizeof(*formations);
 
 /**
  * @brief Start game
  */
 void start() {
-    read();
-    repos();
-
-    int initial = numerics::rand(1, 6);
-
-    enemy[0].set(-2, initial);
-    enemy[1].set(-1, initial);
-    enemy[2].set(-2, initial - 1);
-    enemy[3].set(-2, initial + 1);
+    wave.clear();
 
-    bullet.set(16, 16);
+    alive = 0;
+    descents = 0;
 
-    shot = false;
+    read();
+    spawn();
+    repos();
 }
 
 /**
  * @brief Read peripherals state
  */
 void read() {
-    position = things::first.read(1, 6);
+    position = things::first.read(1, things::width - 2);
 
     bool trigger = false;
 
@@ -64,23 +85,86 @@ void read() {
     trigger = trigger || things::top.read();
     trigger = trigger || things::bottom.read();
 
-    if (trigger) {
-        shot = trigger;
-
-        bullet.set(6, position);
+    if (trigger and not pulled) {
+        fire();
     }
 
+    pulled = trigger;
+
     steps = 20 - 4 * level;
     count = 1 + count % steps;
 }
 
 /**
- * @brief Verify if evade
- *
- * @return Evade
+ * @brief Launch a bullet from ship in first free slot of pool, unless a bullet is still in front of ship
  */
-int evade() {  //
-    return bullet.get(true) == -1;
+void fire() {
+    for (short slot = 0; slot < capacity; slot++) {
+        if ((alive & (1 << slot)) and lines[slot] == things::height - 2 and columns[slot] == position) {
+            return;
+        }
+    }
+
+    for (short slot = 0; slot < capacity; slot++) {
+        if (alive & (1 << slot)) {
+            continue;
+        }
+
+        lines[slot] = things::height - 2;
+        columns[slot] = position;
+
+        alive |= 1 << slot;
+        return;
+    }
+}
+
+/**
+ * @brief Insert a formation row in top of wave
+ */
+void spawn() {
+    board::row row = pgm_read_byte(&formations[numerics::rand(0, kinds - 1)]);
+
+    wave[0] = row << numerics::rand(0, things::width - 8);
+}
+
+/**
+ * @brief Remove bullets and enemies in same pixel, an AND of bullets and wave rows
+ */
+void collide() {
+    if (not alive) {
+        return;
+    }
+
+    board shots;
+
+    for (short slot = 0; slot < capacity; slot++) {
+        if (alive & (1 << slot)) {
+            shots[lines[slot]] |= board::mask(columns[slot]);
+        }
+    }
+
+    for (short line = 0; line < things::height; line++) {
+        board::row hit = wave[line] & shots[line];
+
+        if (not hit) {
+            continue;
+        }
+
+        wave[line] &= ~hit;
+
+        for (short slot = 0; slot < capacity; slot++) {
+            if ((alive & (1 << slot)) and lines[slot] == line and (hit & board::mask(columns[slot]))) {
+                alive &= ~(1 << slot);
+            }
+        }
+
+        for (byte kills = numerics::ones(hit); kills; kills--) {
+            ++points;
+        }
+
+        things::buzzer.play(kill);
+        trace::mark(trace::kill);
+    }
 }
 
 /**
@@ -89,25 +173,15 @@ int evade() {  //
  * @return defeat
  */
 bool verify() {
-    short posBullet[] = {bullet.get(true), bullet.get(false)};
-
-    for (int first = 0; first < 4; first++) {
-        for (int second = 0; second < 4; second++) {
-            short posShip[] = {ship[first].get(true), ship[first].get(false)};
-            short posEnemy[] = {enemy[second].get(true), enemy[second].get(false)};
+    if (wave[things::height - 1]) {
+        ++deads;
+        return true;
+    }
 
-            if (posBullet[0] == posEnemy[0] and posBullet[1] == posEnemy[1]) {
-                points++;
-                return true;
-            }
-            if (posShip[0] == posEnemy[0] and posShip[1] == posEnemy[1]) {
-                deads++;
-                return true;
-            }
-            if (posEnemy[0] == 8) {
-                deads++;
-                return true;
-            }
+    for (auto &part : ship) {
+        if (wave.get(part)) {
+            ++deads;
+            return true;
         }
     }
 
@@ -118,24 +192,38 @@ bool verify() {
  * @brief Update positions
  */
 void repos() {
-    if (shot) {
-        if (count % (steps / 2) == 0) {
-            if (evade()) {
-                shot = false;
-            } else {
-                bullet.translate(-1, 0);
+    if (count % (steps / 2) == 0) {
+        for (short slot = 0; slot < capacity; slot++) {
+            if (not(alive & (1 << slot))) {
+                continue;
+            }
+
+            if (--lines[slot] < 0) {
+                alive &= ~(1 << slot);
             }
         }
     }
 
+    collide();
+
     if (count == steps) {
-        enemy.translate(1, 0);
+        for (short line = things::height - 1; line > 0; line--) {
+            wave[line] = wave[line - 1];
+        }
+
+        wave[0] = 0;
+
+        if (++descents % (4 - level) == 0) {
+            spawn();
+        }
     }
 
-    ship[0].set(7, position);
-    ship[1].set(6, position);
-    ship[2].set(7, position - 1);
-    ship[3].set(7, position + 1);
+    collide();
+
+    ship[0].set(things::height - 1, position);
+    ship[1].set(things::height - 2, position);
+    ship[2].set(things::height - 1, position - 1);
+    ship[3].set(things::height - 1, position + 1);
 }
 
 /**
@@ -143,17 +231,76 @@ void repos() {
  */
 void draw() {
     things::frame.set(ship, true);
-    things::frame.set(enemy, true);
-    things::frame.set(bullet, true);
+    things::frame |= wave;
+
+    for (short slot = 0; slot < capacity; slot++) {
+        if (alive & (1 << slot)) {
+            things::shade.set(geometry::point(lines[slot], columns[slot]), 2);
+        }
+    }
 
-    things::layer.set(0, deads / 10);
-    things::layer.set(1, deads % 10);
-    things::layer.set(2, points / 10);
-    things::layer.set(3, points % 10);
+    deads.write(things::layer, 0);
+    points.write(things::layer, 2);
 
     things::display.separator(true);
 }
 
+/**
+ * @brief Score of game
+ *
+ * @return Killed enemies, in BCD
+ */
+unsigned short result() {  //
+    return points.get();
+}
+
+/**
+ * @brief Automatic player, ship aims to nearest enemy in lowest row of wave and shoots when below it, releasing
+ * trigger between shots
+ */
+void pilot() {
+    short target = position;
+
+    for (short line = things::height - 1; line > -1; line--) {
+        if (not wave[line]) {
+            continue;
+        }
+
+        short nearest = things::width;
+
+        for (short column = 0; column < things::width; column++) {
+            if ((wave[line] & board::mask(column)) and abs(column - position) < nearest) {
+                nearest = abs(column - position);
+                target = column;
+            }
+        }
+
+        break;
+    }
+
+    target = max(1, min(target, things::width - 2));
+
+    things::first.drive(target, 1, things::width - 2);
+
+    bool above = false;
+
+    for (short line = 0; line < things::height - 2; line++) {
+        above = above or (wave[line] & board::mask(position));
+    }
+
+    if (above and not pulled and alive != (1 << capacity) - 1) {
+        things::top.press();
+    }
+}
+
+/**
+ * @brief Reset scores kept between rounds
+ */
+void reset() {
+    deads = 0;
+    points = 0;
+}
+
 /**
  * @brief Update game state
  *
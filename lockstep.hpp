@@ -0,0 +1,456 @@
+#include "pong.hpp"
+#include "things.hpp"
+#include "utils.hpp"
+
+#ifndef LOCKSTEP_HPP
+#define LOCKSTEP_HPP
+
+namespace lockstep {
+/**
+ * Two boards linked by Serial (TX to RX both ways) play pong, each one owning a paddle.
+ * Only inputs cross the link, in a packet sent each frame:
+ *
+ *     sync, kind, tick (2 bytes), inputs of tick and of 3 previous ticks,
+ *     confirmed tick (2 bytes), check of confirmed state, checksum (CRC-8 of previous bytes but sync)
+ *
+ * A hello packet carries a random nonce as tick, the smaller nonce owns left paddle. An input byte holds paddle
+ * position (bits 0 to 3) and level (bits 4 and 5, level of left board rules).
+ *
+ * Local inputs are applied some ticks later (delay), so remote ones usually arrive in time. When they do not, the
+ * last remote input is predicted, and each frame the state is simulated again from the last confirmed one, which is
+ * a rollback when a prediction was wrong. Predicted ticks are simulated quiet, so sounds and trace marks come once,
+ * when a tick is confirmed. A board stalls when it runs a whole window ahead of ticks confirmed in
+ * either board, sending again the inputs other board still misses.
+ */
+struct snapshot {
+    geometry::object<3> left;
+    geometry::object<3> right;
+
+    geometry::point ball;
+    geometry::point sense;
+
+    short first;
+    short second;
+    short level;
+
+    short steps;
+    short count;
+
+    canvas::counter<2> one;
+    canvas::counter<2> two;
+};
+
+const byte sync = 0xB4;
+const byte hello = 0;
+const byte input = 1;
+
+const short size = 12;
+const short redundancy = 4;  // Inputs repeated in each packet, so a lost packet is covered by next ones
+
+const unsigned short delay = 2;
+const unsigned short window = 8;
+
+const short reports = 40;  // Frames between reports
+
+static_assert(delay < window, "Delay must fit in rollback window");
+
+snapshot base;
+
+unsigned short nonce{};
+unsigned short peer{};
+unsigned short seed{};
+bool side{};  // Own right paddle
+bool joined{};
+bool heard{};
+
+unsigned short now{};        // Next tick to simulate
+unsigned short confirmed{};  // Ticks before it have all inputs
+unsigned short acked{};      // Ticks before it are confirmed in other board
+
+byte locals[window];
+byte remotes[window];
+bool known[window];
+byte guess{};
+
+unsigned short stamps[window];
+byte checks[window];
+
+byte packet[size];
+short filled{};
+
+unsigned long stalls{};
+unsigned long rollbacks{};
+unsigned long desyncs{};
+unsigned long losses{};
+short frames{};
+
+/**
+ * @brief Copy pong state
+ *
+ * @param state Snapshot to write
+ */
+void save(snapshot &state) {
+    state.left = pong::left;
+    state.right = pong::right;
+    state.ball = pong::ball;
+    state.sense = pong::sense;
+    state.first = pong::first;
+    state.second = pong::second;
+    state.level = pong::level;
+    state.steps = pong::steps;
+    state.count = pong::count;
+    state.one = pong::one;
+    state.two = pong::two;
+}
+
+/**
+ * @brief Restore pong state
+ *
+ * @param state Snapshot to read
+ */
+void load(const snapshot &state) {
+    pong::left = state.left;
+    pong::right = state.right;
+    pong::ball = state.ball;
+    pong::sense = state.sense;
+    pong::first = state.first;
+    pong::second = state.second;
+    pong::level = state.level;
+    pong::steps = state.steps;
+    pong::count = state.count;
+    pong::one = state.one;
+    pong::two = state.two;
+}
+
+/**
+ * @brief Serve ball, position and sense come from tick and shared seed so both boards agree
+ *
+ * @param tick Tick of serve
+ */
+void serve(unsigned short tick) {
+    byte noise[4] = {byte(tick), byte(tick >> 8), byte(seed), byte(seed >> 8)};
+    byte value = numerics::crc(noise, 4);
+
+    short line = things::height / 2 - (value & 1);
+    short column = things::width / 2 - ((value >> 1) & 1);
+
+    pong::ball.set(line, column);
+    pong::sense.set(1 - 2 * ((value >> 2) & 1), 1 - 2 * ((value >> 3) & 1));
+}
+
+/**
+ * @brief Simulate a tick of pong with inputs of both paddles
+ *
+ * @param tick Tick
+ * @param left Input of left paddle (it holds level too)
+ * @param right Input of right paddle
+ */
+void step(unsigned short tick, byte left, byte right) {
+    pong::level = (left >> 4) & 3;
+
+    pong::first = min(left & 0xF, pong::reach());
+    pong::second = min(right & 0xF, pong::reach());
+
+    pong::advance();
+    pong::repos();
+
+    if (pong::verify()) {
+        serve(tick);
+    }
+}
+
+/**
+ * @brief Ticks from one tick to other, counted across 16 bits wrap
+ *
+ * @param from First tick
+ * @param to Last tick
+ * @return Distance
+ */
+unsigned short distance(unsigned short from, unsigned short to) {  //
+    return to - from;
+}
+
+/**
+ * @brief Local input of a tick, known on both boards before delay
+ *
+ * @param tick Tick
+ * @return Input
+ */
+byte local(unsigned short tick) {  //
+    return tick < delay ? 0 : locals[tick % window];
+}
+
+/**
+ * @brief Send a packet
+ *
+ * @param kind Packet kind
+ * @param tick Tick of last input (nonce in hello)
+ */
+void send(byte kind, unsigned short tick) {
+    byte data[size];
+
+    data[0] = sync;
+    data[1] = kind;
+    data[2] = tick & 0xFF;
+    data[3] = tick >> 8;
+
+    for (short index = 0; index < redundancy; index++) {
+        data[4 + index] = kind == input ? local(tick - index) : 0;
+    }
+
+    unsigned short last = confirmed - 1;
+
+    data[8] = last & 0xFF;
+    data[9] = last >> 8;
+    data[10] = checks[last % window];
+    data[11] = numerics::crc(data + 1, size - 2);
+
+    Serial.write(data, size);
+}
+
+/**
+ * @brief Begin a match, both boards start from same state
+ *
+ * @param other Nonce of other board
+ */
+void join(unsigned short other) {
+    joined = true;
+    heard = false;
+
+    peer = other;
+    side = nonce > other;
+    seed = nonce ^ other;
+
+    now = 0;
+    confirmed = 0;
+    acked = 0;
+    guess = 0;
+
+    for (short index = 0; index < window; index++) {
+        remotes[index] = 0;
+        known[index] = index < delay;
+    }
+
+    pong::level = 0;
+    pong::first = 0;
+    pong::second = 0;
+    pong::count = 0;
+    pong::one = 0;
+    pong::two = 0;
+
+    pong::advance();
+    pong::repos();
+
+    serve(0);
+
+    save(base);
+
+    for (short index = 0; index < window; index++) {
+        stamps[index] = 0xFFFF;
+        checks[index] = numerics::crc(reinterpret_cast<const byte *>(&base), sizeof(base));
+    }
+}
+
+/**
+ * @brief Take a received packet
+ */
+void take() {
+    unsigned short tick = packet[2] | (packet[3] << 8);
+
+    if (packet[1] == hello) {
+        if (tick == nonce) {
+            nonce = numerics::rand(0, 0xFFFE);
+        } else if (not joined or tick != peer) {
+            join(tick);
+        }
+
+        return;
+    }
+
+    if (not joined) {
+        return;
+    }
+
+    heard = true;
+
+    for (short index = 0; index < redundancy; index++) {
+        unsigned short other = tick - index;
+
+        if (distance(confirmed, other) >= window or known[other % window]) {
+            continue;
+        }
+
+        byte value = packet[4 + index];
+
+        if (distance(confirmed, other) < distance(confirmed, now) and value != guess) {
+            rollbacks++;
+        }
+
+        remotes[other % window] = value;
+        known[other % window] = true;
+    }
+
+    unsigned short last = packet[8] | (packet[9] << 8);
+
+    if (distance(acked, last + 1) < window) {
+        acked = last + 1;
+    }
+
+    if (stamps[last % window] == last and checks[last % window] != packet[10]) {
+        desyncs++;
+    }
+}
+
+/**
+ * @brief Read received bytes into packets
+ */
+void receive() {
+    while (Serial.available()) {
+        byte data = Serial.read();
+
+        if (filled == 0 and data != sync) {
+            continue;
+        }
+
+        packet[filled++] = data;
+
+        if (filled < size) {
+            continue;
+        }
+
+        filled = 0;
+
+        if (numerics::crc(packet + 1, size - 2) != packet[size - 1]) {
+            losses++;
+            continue;
+        }
+
+        take();
+    }
+}
+
+/**
+ * @brief Report link counters as a JSON line (other board skips it as it has no sync byte)
+ */
+void report() {
+    if (++frames < reports) {
+        return;
+    }
+
+    frames = 0;
+
+    Serial.print(F("{\"link\":{\"side\":"));
+    Serial.print(side);
+    Serial.print(F(",\"tick\":"));
+    Serial.print(now);
+    Serial.print(F(",\"lag\":"));
+    Serial.print(distance(confirmed, now));
+    Serial.print(F(",\"stalls\":"));
+    Serial.print(stalls);
+    Serial.print(F(",\"rollbacks\":"));
+    Serial.print(rollbacks);
+    Serial.print(F(",\"desyncs\":"));
+    Serial.print(desyncs);
+    Serial.print(F(",\"losses\":"));
+    Serial.print(losses);
+    Serial.println(F("}}"));
+}
+
+/**
+ * @brief Start game
+ */
+void start() {
+    pong::start();
+
+    if (not things::lockstep) {
+        return;
+    }
+
+    joined = false;
+    filled = 0;
+
+    nonce = numerics::rand(0, 0xFFFE);
+}
+
+/**
+ * @brief Update game state, a frame of linked simulation
+ *
+ * @param value Game level
+ */
+void update(int value) {
+    if (not things::lockstep) {
+        pong::update(value);
+        return;
+    }
+
+    receive();
+
+    if (not joined or not heard) {
+        send(hello, nonce);
+    }
+
+    if (not joined) {
+        pong::draw();
+        return;
+    }
+
+    if (distance(confirmed, now + delay) >= window or distance(acked, now + delay) >= window) {
+        unsigned short last = now + delay - 1;
+
+        send(input, min(distance(acked, last), redundancy - 1) + acked);
+
+        stalls++;
+    } else {
+        locals[(now + delay) % window] = things::first.read(0, pong::reach()) | (value << 4);
+
+        send(input, now + delay);
+
+        unsigned short next = now + 1;
+
+        load(base);
+
+        while (confirmed != next and known[confirmed % window]) {
+            byte other = remotes[confirmed % window];
+
+            step(confirmed, side ? other : local(confirmed), side ? local(confirmed) : other);
+
+            known[confirmed % window] = false;
+            guess = other;
+
+            confirmed++;
+        }
+
+        save(base);
+
+        unsigned short last = confirmed - 1;
+
+        stamps[last % window] = last;
+        checks[last % window] = numerics::crc(reinterpret_cast<const byte *>(&base), sizeof(base));
+
+        pong::quiet = true;
+
+        for (unsigned short tick = confirmed; tick != next; tick++) {
+            step(tick, side ? guess : local(tick), side ? local(tick) : guess);
+        }
+
+        pong::quiet = false;
+
+        now = next;
+    }
+
+    pong::draw();
+
+    report();
+}
+
+/**
+ * @brief Verify defeat, never in a linked match as rounds restart inside simulation
+ *
+ * @return Defeat
+ */
+bool verify() {  //
+    return things::lockstep ? false : pong::verify();
+}
+}  // namespace lockstep
+
+#endif
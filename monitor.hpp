@@ -0,0 +1,164 @@
+#include "things.hpp"
+
+#ifndef MONITOR_HPP
+#define MONITOR_HPP
+
+#ifdef __AVR__
+extern char __heap_start;
+extern char *__brkval;
+#endif
+
+namespace monitor {
+const byte canary = 0xC5;
+
+const unsigned short chunk = 200;  // Loop iterations by idle sample
+const short calibration = 64;      // Samples with interrupts disabled at boot
+
+unsigned long base{};  // Microseconds of calibration samples
+
+unsigned long measured{};  // Microseconds of idle samples in this second
+unsigned long samples{};   // Idle samples in this second
+unsigned long since{};
+
+/**
+ * @brief Run an idle sample, a fixed busy loop
+ *
+ * @return Microseconds spent
+ */
+unsigned long sample() {
+    unsigned long start = micros();
+
+    for (volatile unsigned short index = 0; index < chunk; index++) {
+    }
+
+    return micros() - start;
+}
+
+/**
+ * @brief Lowest address free to stack
+ *
+ * @return Address
+ */
+byte *bottom() {
+#ifdef __AVR__
+    return reinterpret_cast<byte *>(__brkval ? __brkval : &__heap_start);
+#elif defined(HOST_HPP)
+    return host::ground;
+#else
+    return nullptr;
+#endif
+}
+
+/**
+ * @brief Gap between heap and stack now
+ *
+ * @return Bytes
+ */
+short gap() {
+#ifdef __AVR__
+    return reinterpret_cast<byte *>(SP) - bottom();
+#elif defined(HOST_HPP)
+    return host::stack() - bottom();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Paint free memory with canary and calibrate idle samples without interrupts
+ */
+void paint() {
+    if (not things::monitor) {
+        return;
+    }
+
+#ifdef __AVR__
+    byte *top = reinterpret_cast<byte *>(SP) - 32;
+
+    for (byte *address = bottom(); address < top; address++) {
+        *address = canary;
+    }
+#elif defined(HOST_HPP)
+    host::paint(canary);
+#endif
+
+    for (short index = 0; index < calibration; index++) {
+        noInterrupts();
+        base += sample();
+        interrupts();
+    }
+
+    since = millis();
+}
+
+/**
+ * @brief Bytes never reached by stack since boot (stack high water mark)
+ *
+ * @return Bytes
+ */
+short unused() {
+    short count = 0;
+
+#ifdef __AVR__
+    byte *top = reinterpret_cast<byte *>(SP);
+
+    for (byte *address = bottom(); address < top and *address == canary; address++) {
+        count++;
+    }
+#elif defined(HOST_HPP)
+    count = host::unused(canary);
+#endif
+
+    return count;
+}
+
+/**
+ * @brief Spend idle time in a sample, slowed only by interrupt handlers
+ */
+void idle() {
+    if (not things::monitor) {
+        return;
+    }
+
+    measured += sample();
+    samples++;
+}
+
+/**
+ * @brief Report memory and CPU share over Serial as a JSON line once per second
+ *
+ * Interrupt share is the slowdown of idle samples against the calibration
+ */
+void report() {
+    if (not things::monitor) {
+        return;
+    }
+
+    unsigned long elapsed = millis() - since;
+
+    if (elapsed < 1000) {
+        return;
+    }
+
+    unsigned long expected = base * samples / calibration;
+
+    short handlers = measured > expected ? 1000 - 1000 * expected / measured : 0;  // Not below calibration rounding
+    short idle = measured / elapsed;
+
+    Serial.print(F("{\"gap\":"));
+    Serial.print(gap());
+    Serial.print(F(",\"stack\":"));
+    Serial.print(unused());
+    Serial.print(F(",\"interrupts\":"));
+    Serial.print(handlers);
+    Serial.print(F(",\"idle\":"));
+    Serial.print(idle);
+    Serial.println(F("}"));
+
+    measured = 0;
+    samples = 0;
+    since = millis();
+}
+}  // namespace monitor
+
+#endif
@@ -1,5 +1,6 @@
 #include "geometry.hpp"
 #include "things.hpp"
+#include "trace.hpp"
 #include "utils.hpp"
 
 #ifndef PONG_HPP
@@ -19,18 +20,34 @@ short level{};
 short steps{};
 short count{};
 
-short one{};
-short two{};
+canvas::counter<2> one;
+canvas::counter<2> two;
+
+bool quiet{};  // Tick is simulated again (see lockstep.hpp), so it makes no sound nor trace marks
+
+/**
+ * @brief Bytes of game state in RAM, listed along with globals above
+ */
+const short footprint = sizeof(left) + sizeof(right) + sizeof(ball) + sizeof(sense) + sizeof(first) + sizeof(second) +
+                        sizeof(level) + sizeof(steps) + sizeof(count) + sizeof(one) + sizeof(two) + sizeof(quiet);
 
 void start();
+short reach();
 void read();
+void advance();
 void draw();
 void repos();
+void bounce();
 int collision();
 bool verify();
+unsigned short result();
+void pilot();
+void reset();
 void update(int);
 
-canvas::frame image({0b11111111, 0b10000001, 0b10000101, 0b10100101, 0b10100101, 0b10100001, 0b10000001, 0b11111111});
+const devices::note hit[] PROGMEM = {{988, 30}, {0, 0}};
+
+const byte image[8] PROGMEM = {0b11111111, 0b10000001, 0b10000101, 0b10100101, 0b10100101, 0b10100001, 0b10000001, 0b11111111};
 
 /**
  * @brief Start game
@@ -39,7 +56,10 @@ void start() {
     read();
     repos();
 
-    ball.set(numerics::rand(3, 4), numerics::rand(3, 4));
+    short line = things::height / 2;
+    short column = things::width / 2;
+
+    ball.set(numerics::rand(line - 1, line), numerics::rand(column - 1, column));
 
     sense.set(1 - 2 * numerics::rand(0, 1), 1 - 2 * numerics::rand(0, 1));
 
@@ -48,21 +68,39 @@ void start() {
 }
 
 /**
- * @brief Read peripherals state
+ * @brief Highest paddle position, paddles get shorter with level
+ *
+ * @return Paddle position limit
  */
-void read() {
-    int limit = 5;
+short reach() {
+    short limit = things::height - 3;
 
     if (level > 1) {
-        limit = 6;
+        limit = things::height - 2;
     }
     if (level > 2) {
-        limit = 7;
+        limit = things::height - 1;
     }
 
+    return limit;
+}
+
+/**
+ * @brief Read peripherals state
+ */
+void read() {
+    short limit = reach();
+
     first = things::first.read(0, limit);
     second = things::second.read(0, limit);
 
+    advance();
+}
+
+/**
+ * @brief Advance frame count, ball moves when it reaches the steps of level
+ */
+void advance() {
     steps = 20 - 4 * level;
     count = 1 + count % steps;
 }
@@ -76,10 +114,8 @@ void draw() {
 
     things::frame.set(ball, true);
 
-    things::layer.set(0, one / 10);
-    things::layer.set(1, one % 10);
-    things::layer.set(2, two / 10);
-    things::layer.set(3, two % 10);
+    one.write(things::layer, 0);
+    two.write(things::layer, 2);
 
     things::display.separator(true);
 }
@@ -90,16 +126,16 @@ void draw() {
 void repos() {
     for (byte index = 0; index < 3; index++) {
         left[index].set(first + index, 0);
-        right[index].set(second + index, 7);
+        right[index].set(second + index, things::width - 1);
     }
 
     if (level > 1) {
         left[2].set(first, 0);
-        right[2].set(second, 7);
+        right[2].set(second, things::width - 1);
     }
     if (level > 2) {
         left[1].set(first, 0);
-        right[1].set(second, 7);
+        right[1].set(second, things::width - 1);
     }
 
     if (count == steps) {
@@ -113,9 +149,11 @@ void repos() {
                 break;
             case 2:
                 sense.set(sense.get(true), -sense.get(false));
+                bounce();
                 break;
             case 3:
                 sense.set(-sense.get(true), -sense.get(false));
+                bounce();
                 break;
         }
 
@@ -123,6 +161,18 @@ void repos() {
     }
 }
 
+/**
+ * @brief Sound and mark ball bouncing on a paddle, unless tick is simulated again
+ */
+void bounce() {
+    if (quiet) {
+        return;
+    }
+
+    things::buzzer.play(hit);
+    trace::mark(trace::hit);
+}
+
 /**
  * @brief Verify collision
  *
@@ -145,17 +195,17 @@ int collision() {
         if (column == 1 and first == 0) {
             return 3;
         }
-        if (column == 6 and second == 0) {
+        if (column == things::width - 2 and second == 0) {
             return 3;
         }
 
         return 1;
     }
-    if (line == 7) {
-        if (column == 1 and first == 5 + increase) {
+    if (line == things::height - 1) {
+        if (column == 1 and first == things::height - 3 + increase) {
             return 3;
         }
-        if (column == 6 and second == 5 + increase) {
+        if (column == things::width - 2 and second == things::height - 3 + increase) {
             return 3;
         }
 
@@ -172,7 +222,7 @@ int collision() {
 
         return 2;
     }
-    if (column == 6) {
+    if (column == things::width - 2) {
         if (second > line) {
             return 0;
         }
@@ -196,11 +246,11 @@ bool verify() {
         byte column = ball.get(false);
 
         if (column == 0) {
-            two++;
+            ++two;
             return true;
         }
-        if (column == 7) {
-            one++;
+        if (column == things::width - 1) {
+            ++one;
             return true;
         }
     }
@@ -208,6 +258,39 @@ bool verify() {
     return false;
 }
 
+/**
+ * @brief Score of game
+ *
+ * @return Best score between players, in BCD
+ */
+unsigned short result() {  //
+    return max(one.get(), two.get());
+}
+
+/**
+ * @brief Automatic player, both paddles track the line of ball
+ */
+void pilot() {
+    short target = ball.get(true);
+
+    if (level < 2) {
+        target--;
+    }
+
+    target = max(0, min(target, reach()));
+
+    things::first.drive(target, 0, reach());
+    things::second.drive(target, 0, reach());
+}
+
+/**
+ * @brief Reset scores kept between rounds
+ */
+void reset() {
+    one = 0;
+    two = 0;
+}
+
 /**
  * @brief Update game state
  *
@@ -0,0 +1,203 @@
+#include "things.hpp"
+
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+namespace profile {
+const short updating = 0;
+const short screening = 1;
+const short displaying = 2;
+const short phases = 3;
+
+const short frames = 40;
+const short buckets = 8;
+
+unsigned long spent[phases]{};
+unsigned long moments[phases]{};
+
+unsigned long busy{};
+unsigned long peak{};
+short overruns{};
+
+short count{};
+short game{-1};
+short level{-1};
+
+unsigned short latencies[buckets]{};
+unsigned long pending{};
+unsigned long seen{};
+unsigned long sensed{};
+bool waiting{};
+
+canvas::frame<things::width, things::height> shown;
+
+/**
+ * @brief Start measuring a phase
+ *
+ * @param phase Phase started
+ */
+void begin(short phase) {
+    if (not things::profile) {
+        return;
+    }
+
+    moments[phase] = micros();
+}
+
+/**
+ * @brief Finish measuring a phase
+ *
+ * @param phase Phase finished
+ */
+void end(short phase) {
+    if (not things::profile) {
+        return;
+    }
+
+    spent[phase] += micros() - moments[phase];
+}
+
+/**
+ * @brief Account the busy time of a whole frame against the period budget
+ *
+ * @param elapsed Microseconds spent in frame before sleeping
+ */
+void frame(unsigned long elapsed) {
+    if (not things::profile) {
+        return;
+    }
+
+    busy += elapsed;
+    peak = max(peak, elapsed);
+
+    if (elapsed > 1000ul * things::period) {
+        overruns++;
+    }
+}
+
+/**
+ * @brief Match button presses and knob moves with the first rendered frame that changes after them
+ *
+ * Only press edges and knob moves beyond noise count, as releases and knob jitter need
+ * no response. A frame may change on its own (a falling block, a moving ball), so each
+ * latency is an upper bound of the time until the input shows. Latencies are counted in
+ * buckets of one frame period, and inputs followed by no change within a second are discarded.
+ * Pixels of shade planes count as lit, so ghosts and tails moving show as changes
+ *
+ * @param base Frame rendered in screen
+ * @param shade Shade planes rendered in screen
+ */
+template <const short depth>
+void render(const canvas::frame<things::width, things::height> &base,
+            const canvas::planes<depth, things::width, things::height> &shade) {
+    if (not things::profile) {
+        return;
+    }
+
+    canvas::frame<things::width, things::height> image = shade.lit();
+
+    image |= base;
+
+    if (devices::pressed != seen or devices::dialed != sensed) {
+        if (not waiting) {
+            pending = devices::pressed != seen ? devices::pressed : devices::dialed;
+            waiting = true;
+        }
+
+        seen = devices::pressed;
+        sensed = devices::dialed;
+    }
+
+    if (waiting) {
+        unsigned long elapsed = (micros() - pending) / 1000;
+
+        if (not(image == shown)) {
+            short bucket = min(elapsed / things::period, buckets - 1ul);
+
+            latencies[bucket]++;
+            waiting = false;
+        } else if (elapsed > 1000) {
+            waiting = false;
+        }
+    }
+
+    shown = image;
+}
+
+/**
+ * @brief Clear accumulated measures
+ */
+void reset() {
+    for (unsigned long &value : spent) {
+        value = 0;
+    }
+
+    busy = 0;
+    peak = 0;
+    overruns = 0;
+
+    count = 0;
+}
+
+/**
+ * @brief Account a frame and report averages over Serial as a JSON line
+ *
+ * @param choice Game running
+ * @param value Game level
+ */
+void report(short choice, short value) {
+    if (not things::profile) {
+        return;
+    }
+
+    if (choice != game) {
+        for (unsigned short &value : latencies) {
+            value = 0;
+        }
+    }
+
+    if (choice != game or value != level) {
+        game = choice;
+        level = value;
+
+        reset();
+        return;
+    }
+
+    if (++count < frames) {
+        return;
+    }
+
+    Serial.print(F("{\"game\":"));
+    Serial.print(game);
+    Serial.print(F(",\"level\":"));
+    Serial.print(level);
+    Serial.print(F(",\"update\":"));
+    Serial.print(spent[updating] / frames);
+    Serial.print(F(",\"screen\":"));
+    Serial.print(spent[screening] / frames);
+    Serial.print(F(",\"display\":"));
+    Serial.print(spent[displaying] / frames);
+    Serial.print(F(",\"frame\":"));
+    Serial.print(busy / frames);
+    Serial.print(F(",\"peak\":"));
+    Serial.print(peak);
+    Serial.print(F(",\"overruns\":"));
+    Serial.print(overruns);
+    Serial.print(F(",\"latency\":["));
+
+    for (short index = 0; index < buckets; index++) {
+        if (index) {
+            Serial.print(F(","));
+        }
+
+        Serial.print(latencies[index]);
+    }
+
+    Serial.println(F("]}"));
+
+    reset();
+}
+}  // namespace profile
+
+#endif
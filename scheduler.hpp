@@ -0,0 +1,97 @@
+#include "trace.hpp"
+
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+namespace scheduler {
+/**
+ * @class task
+ * @brief Stackless periodic task, run to completion each time it is due
+ *
+ */
+class task {
+   private:
+    void (*routine)(void);
+
+    unsigned short period;
+    unsigned long last;
+
+    bool traced;
+
+   public:
+    /**
+     * @brief Initialize task
+     *
+     * @param routine Function run each period
+     * @param period Period in milliseconds
+     * @param traced If runs are recorded as trace spans (frequent tasks would overrun Serial)
+     */
+    task(void (*routine)(void), unsigned short period, bool traced = true)
+        : routine(routine), period(period), last(0), traced(traced) {}
+
+    /**
+     * @brief Verify if runs are recorded as trace spans
+     *
+     * @return Traced
+     */
+    bool spanned() const {  //
+        return traced;
+    }
+
+    /**
+     * @brief Verify if task is due
+     *
+     * @param now Current moment in milliseconds
+     * @return Due
+     */
+    bool due(unsigned long now) const {  //
+        return now - last >= period;
+    }
+
+    /**
+     * @brief Run task and schedule its next period
+     *
+     * @param now Current moment in milliseconds
+     */
+    void run(unsigned long now) {
+        last += period;
+
+        if (now - last >= period) {
+            last = now;
+        }
+
+        routine();
+    }
+};
+
+/**
+ * @brief Run the first due task, so tasks earlier in array have priority
+ *
+ * @param tasks Tasks sorted by priority
+ * @return Index of task run (-1 when none was due)
+ */
+template <const short size>
+short dispatch(task (&tasks)[size]) {
+    unsigned long now = millis();
+
+    for (short index = 0; index < size; index++) {
+        if (tasks[index].due(now)) {
+            if (tasks[index].spanned()) {
+                trace::begin(index);
+            }
+
+            tasks[index].run(now);
+
+            if (tasks[index].spanned()) {
+                trace::end(index);
+            }
+
+            return index;
+        }
+    }
+
+    return -1;
+}
+}  // namespace scheduler
+
+#endif
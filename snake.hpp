@@ -1,17 +1,22 @@
 #include "geometry.hpp"
 #include "things.hpp"
+#include "trace.hpp"
 
 #ifndef SNAKE_HPP
 #define SNAKE_HPP
 
 namespace snake {
-static const short size{64};
+static const short size{things::width * things::height};
+static const short capacity{3};
 
 geometry::object<size> body;
 
 geometry::point food;
 geometry::point sense;
 
+geometry::point turns[capacity];  // Pending changes of sense, one applied by move
+short pending{};
+
 bool left{};
 bool right{};
 bool top{};
@@ -23,18 +28,31 @@ short steps{};
 short count{};
 
 short length{};
-short points{};
+canvas::counter<2> points;
+
+/**
+ * @brief Bytes of game state in RAM, listed along with globals above
+ */
+const short footprint = sizeof(body) + sizeof(food) + sizeof(sense) + sizeof(turns) + sizeof(pending) + sizeof(left) +
+                        sizeof(right) + sizeof(top) + sizeof(bottom) + sizeof(level) + sizeof(steps) + sizeof(count) +
+                        sizeof(length) + sizeof(points);
 
 void start();
 void read();
+void turn(short, short);
 void draw();
 void repos();
 bool found();
 void change();
 bool verify();
+unsigned short result();
+void pilot();
+void reset();
 void update(int);
 
-canvas::frame image({0b11111111, 0b10000001, 0b10011001, 0b10010001, 0b10011101, 0b10111101, 0b10000001, 0b11111111});
+const devices::note eat[] PROGMEM = {{1319, 40}, {1760, 60}, {0, 0}};
+
+const byte image[8] PROGMEM = {0b11111111, 0b10000001, 0b10011001, 0b10010001, 0b10011101, 0b10111101, 0b10000001, 0b11111111};
 
 /**
  * @brief Start game
@@ -48,16 +66,18 @@ void start() {
     length = 1;
     points = 1;
 
-    short line = numerics::rand(3, 4);
-    short column = numerics::rand(3, 4);
+    short line = numerics::rand(things::height / 2 - 1, things::height / 2);
+    short column = numerics::rand(things::width / 2 - 1, things::width / 2);
 
     for (auto &part : body) {
         part.set(line, column);
     }
 
-    food.set(numerics::rand(0, 7), numerics::rand(0, 7));
+    food.set(numerics::rand(0, things::height - 1), numerics::rand(0, things::width - 1));
 
     sense.set(0, 0);
+
+    pending = 0;
 }
 
 /**
@@ -69,39 +89,64 @@ void read() {
     top = things::top.read();
     right = things::bottom.read();
 
-    short line = sense.get(true);
-    short column = sense.get(false);
-
-    if (line or (not(line or column))) {
-        if (left) {
-            sense.set(0, -1);
-        } else if (right) {
-            sense.set(0, 1);
-        }
+    if (left) {
+        turn(0, -1);
     }
-    if (column or (not(line or column))) {
-        if (top) {
-            sense.set(-1, 0);
-        } else if (bottom) {
-            sense.set(1, 0);
-        }
+    if (right) {
+        turn(0, 1);
+    }
+    if (top) {
+        turn(-1, 0);
+    }
+    if (bottom) {
+        turn(1, 0);
     }
 
     steps = 20 - 4 * level;
     count = 1 + count % steps;
 }
 
+/**
+ * @brief Queue a change of sense, valid only across the last queued (or current) sense, or from a stop
+ *
+ * @param line Vertical sense
+ * @param column Horizontal sense
+ */
+void turn(short line, short column) {
+    if (pending == capacity) {
+        return;
+    }
+
+    geometry::point last{pending ? turns[pending - 1] : sense};
+
+    bool stopped = last.get(true) == 0 and last.get(false) == 0;
+    bool across = (line != 0) != (last.get(true) != 0);
+
+    if (not(stopped or across)) {
+        return;
+    }
+
+    turns[pending++].set(line, column);
+}
+
 /**
  * @brief Draw game in screen and display
  */
 void draw() {
-    things::frame.set(body, true);
+    short tail = length - length / 3;
+
+    for (short index = 0; index < length; index++) {
+        if (index < tail) {
+            things::frame.set(body[index], true);
+        } else {
+            things::shade.set(body[index], 2);
+        }
+    }
 
     things::frame.set(food, true);
 
     things::layer.set(0, -1);
-    things::layer.set(1, points / 10);
-    things::layer.set(2, points % 10);
+    points.write(things::layer, 1);
     things::layer.set(3, -1);
 
     things::display.separator(false);
@@ -122,10 +167,10 @@ bool verify() {
     short line = body[0].get(true);
     short column = body[1].get(false);
 
-    if (line < 0 or line > 7) {
+    if (line < 0 or line > things::height - 1) {
         return true;
     }
-    if (column < 0 or column > 7) {
+    if (column < 0 or column > things::width - 1) {
         return true;
     }
 
@@ -145,20 +190,14 @@ bool found() {  //
  * @brief Change food position
  */
 void change() {
-    while (true) {
-        food.set(numerics::rand(0, 7), numerics::rand(0, 7));
+    canvas::frame<things::width, things::height> occupied;
 
-        bool valid = true;
+    occupied.set(body, true);
 
-        for (auto &part : body) {
-            if (food == part) {
-                valid = false;
-
-                break;
-            }
-        }
+    while (true) {
+        food.set(numerics::rand(0, things::height - 1), numerics::rand(0, things::width - 1));
 
-        if (valid) {
+        if (not occupied.get(food)) {
             break;
         }
     }
@@ -169,6 +208,16 @@ void change() {
  */
 void repos() {
     if (count == steps) {
+        if (pending) {
+            sense = turns[0];
+
+            for (short index = 1; index < pending; index++) {
+                turns[index - 1] = turns[index];
+            }
+
+            pending--;
+        }
+
         short index = length - 1;
 
         while (index) {
@@ -180,10 +229,14 @@ void repos() {
         body[index].translate(sense);
 
         if (found()) {
+            trace::begin(trace::food);
             change();
+            trace::end(trace::food);
+
+            things::buzzer.play(eat);
 
             length++;
-            points++;
+            ++points;
         } else {
             index = length;
 
@@ -196,6 +249,142 @@ void repos() {
     }
 }
 
+/**
+ * @brief Score of game
+ *
+ * @return Eaten foods, in BCD
+ */
+unsigned short result() {  //
+    return points.get();
+}
+
+/**
+ * @brief Automatic player, a breadth first search from food gives distances and head takes the nearest neighbor
+ *
+ * Search expands a frontier of cells as a frame, a step at a time, so it needs no memory by cell and stops once
+ * distances of all neighbors of head are known
+ */
+void pilot() {
+    if (pending) {
+        return;
+    }
+
+    typedef canvas::frame<things::width, things::height> board;
+
+    static const short moves[4][2] = {{0, -1}, {1, 0}, {-1, 0}, {0, 1}};
+
+    board blocked;
+
+    for (short index = 1; index < length - 1; index++) {
+        blocked.set(body[index], true);
+    }
+
+    short distances[4];
+    short unknown = 0;
+
+    for (short index = 0; index < 4; index++) {
+        short line = body[0].get(true) + moves[index][0];
+        short column = body[0].get(false) + moves[index][1];
+
+        distances[index] = size;  // Unreachable
+
+        unknown += board::inside(line, column) and not blocked.get(line, column);
+    }
+
+    board frontier;
+
+    frontier.set(food, true);
+
+    board visited = frontier;
+
+    bool reached = board::inside(food.get(true), food.get(false));
+
+    for (short step = 0; reached and unknown; step++) {
+        for (short index = 0; index < 4; index++) {
+            short line = body[0].get(true) + moves[index][0];
+            short column = body[0].get(false) + moves[index][1];
+
+            if (distances[index] == size and frontier.get(line, column) and not blocked.get(line, column)) {
+                distances[index] = step;
+                unknown--;
+            }
+        }
+
+        board next;
+
+        reached = false;
+
+        for (short line = 0; line < things::height; line++) {
+            board::row around = ((frontier[line] << 1) | (frontier[line] >> 1)) & board::full();
+
+            if (line > 0) {
+                around |= frontier[line - 1];
+            }
+            if (line < things::height - 1) {
+                around |= frontier[line + 1];
+            }
+
+            next[line] = around & ~blocked[line] & ~visited[line];
+            visited[line] |= next[line];
+
+            reached = reached or next[line];
+        }
+
+        frontier = next;
+    }
+
+    short choice = -1;
+    short nearest = 0;
+
+    for (short index = 0; index < 4; index++) {
+        short line = body[0].get(true) + moves[index][0];
+        short column = body[0].get(false) + moves[index][1];
+
+        bool back = moves[index][0] == -sense.get(true) and moves[index][1] == -sense.get(false);
+
+        if (back and length > 1) {
+            continue;
+        }
+        if (not blocked.inside(line, column) or blocked.get(line, column)) {
+            continue;
+        }
+
+        if (choice < 0 or distances[index] < nearest) {
+            choice = index;
+            nearest = distances[index];
+        }
+    }
+
+    if (choice < 0) {
+        return;
+    }
+    if (moves[choice][0] == sense.get(true) and moves[choice][1] == sense.get(false)) {
+        return;
+    }
+
+    switch (choice) {
+        case 0:
+            things::left.press();
+            break;
+        case 1:
+            things::right.press();
+            break;
+        case 2:
+            things::top.press();
+            break;
+        case 3:
+            things::bottom.press();
+            break;
+    }
+}
+
+/**
+ * @brief Reset scores kept between rounds
+ */
+void reset() {
+    points = 0;
+}
+
 /**
  * @brief Update game state
  *
@@ -0,0 +1,178 @@
+#include <avr/eeprom.h>
+
+#include "utils.hpp"
+
+#ifndef STORAGE_HPP
+#define STORAGE_HPP
+
+namespace storage {
+/**
+ * @brief Record saved in EEPROM, written each time in next slot of a ring (scores in BCD)
+ */
+struct record {
+    byte version;
+    byte sequence;
+    unsigned short scores[4];
+    byte bright;
+    byte level;
+    byte check;
+};
+
+const byte version = 0x5B;
+
+const short slots = 32;
+const short size = sizeof(record);
+
+const unsigned long hold = 30000;  // Milliseconds to batch changes before writing
+
+record current{version, 0, {}, 0, 0, 0};  // Record staged in RAM
+record saved{};                           // Record being written
+
+short slot{-1};
+short index{};
+
+bool dirty{};
+bool writing{};
+
+unsigned long since{};
+
+/**
+ * @brief Checksum of a record
+ *
+ * @param other Record
+ * @return Checksum
+ */
+byte checksum(const record &other) {  //
+    return numerics::crc(reinterpret_cast<const byte *>(&other), offsetof(record, check));
+}
+
+/**
+ * @brief Address of a slot in EEPROM
+ *
+ * @param position Slot
+ * @return Address
+ */
+byte *address(short position) {  //
+    return reinterpret_cast<byte *>(position * size);
+}
+
+/**
+ * @brief Load newest valid record in EEPROM
+ *
+ * @return If a valid record was found
+ */
+bool load() {
+    bool found = false;
+
+    for (short position = 0; position < slots; position++) {
+        record other;
+
+        eeprom_read_block(&other, address(position), size);
+
+        if (other.version != version or other.check != checksum(other)) {
+            continue;
+        }
+
+        if (not found or byte(other.sequence - current.sequence) < 128) {
+            current = other;
+            slot = position;
+
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * @brief Stage a game score, kept if it is the best one
+ *
+ * @param game Game
+ * @param value Score
+ */
+void score(short game, unsigned short value) {
+    if (value <= current.scores[game]) {
+        return;
+    }
+
+    current.scores[game] = value;
+
+    if (not dirty) {
+        since = millis();
+    }
+
+    dirty = true;
+}
+
+/**
+ * @brief Stage brightness and level
+ *
+ * @param bright Brightness
+ * @param level Level
+ */
+void settings(byte bright, byte level) {
+    if (abs(bright - current.bright) < 3 and level == current.level) {
+        return;
+    }
+
+    current.bright = bright;
+    current.level = level;
+
+    if (not dirty) {
+        since = millis();
+    }
+
+    dirty = true;
+}
+
+/**
+ * @brief Best score of a game
+ *
+ * @param game Game
+ * @return Score
+ */
+unsigned short best(short game) {  //
+    return current.scores[game];
+}
+
+/**
+ * @brief Write staged changes a byte at a time, only when EEPROM is idle
+ */
+void tick() {
+    if (writing) {
+        if (not eeprom_is_ready()) {
+            return;
+        }
+
+        const byte *data = reinterpret_cast<const byte *>(&saved);
+        byte *target = address(slot) + index;
+
+        if (eeprom_read_byte(target) != data[index]) {
+            eeprom_write_byte(target, data[index]);
+        }
+
+        if (++index == size) {
+            writing = false;
+        }
+
+        return;
+    }
+
+    if (not dirty or millis() - since < hold) {
+        return;
+    }
+
+    current.sequence++;
+    current.check = checksum(current);
+
+    saved = current;
+
+    slot = (slot + 1) % slots;
+    index = 0;
+
+    dirty = false;
+    writing = true;
+}
+}  // namespace storage
+
+#endif
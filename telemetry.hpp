@@ -0,0 +1,138 @@
+#include "things.hpp"
+
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+namespace telemetry {
+/**
+ * Packet sent each frame, only when it fits in Serial transmission buffer:
+ *
+ *     sync, sequence, flags, time (2 bytes), rows mask, width,
+ *     changed rows (row size bytes each, most significant first, first column in bit width - 1),
+ *     digits (4 bytes, if layer flag), checksum (sum of previous bytes)
+ *
+ * Flags hold layer changed (bit 0), key packet (bit 1) and row size (bits 4 to 6).
+ * Sequence counts every frame, so frames unchanged or skipped show as a gap.
+ */
+typedef canvas::frame<things::width, things::height> image;
+
+const byte sync = 0xA5;
+const byte layered = 1 << 0;
+const byte keyed = 1 << 1;
+
+const short keys = 64;  // Packets between key packets
+const short bytes = (things::width + 7) / 8;  // Row size, as row type may be wider than frame
+const short size = 7 + things::height * bytes + 4 + 1;
+
+static_assert(things::height <= 8, "Rows mask holds up to 8 rows");
+
+image frame;
+canvas::layer layer;
+
+byte sequence{};
+short count{};
+
+byte buffer[size];
+short length{};
+byte sum{};
+
+/**
+ * @brief Append a byte to packet
+ *
+ * @param data Byte
+ */
+void put(byte data) {
+    buffer[length++] = data;
+    sum += data;
+}
+
+/**
+ * @brief Send rendered frame and layer as a delta from last sent ones
+ *
+ * Pixels of shade planes are sent lit, so ghosts and tails show at any level
+ *
+ * @param base Frame rendered in screen
+ * @param shade Shade planes rendered in screen
+ * @param segments Layer rendered in display
+ */
+template <const short depth>
+void send(const image &base, const canvas::planes<depth, things::width, things::height> &shade,
+          canvas::layer &segments) {
+    if (not things::telemetry) {
+        return;
+    }
+
+    image pattern = shade.lit();
+
+    pattern |= base;
+
+    sequence++;
+
+    bool key = count == 0;
+
+    byte mask = 0;
+    byte flags = bytes << 4;
+
+    for (short index = 0; index < things::height; index++) {
+        if (key or pattern[index] != frame[index]) {
+            mask |= 1 << index;
+        }
+    }
+
+    for (short index = 0; index < 4; index++) {
+        if (key or segments[index] != layer[index]) {
+            flags |= layered;
+        }
+    }
+
+    if (key) {
+        flags |= keyed;
+    }
+
+    if (mask == 0 and not(flags & layered)) {
+        return;
+    }
+
+    unsigned short time = millis();
+
+    length = 0;
+    sum = 0;
+
+    put(sync);
+    put(sequence);
+    put(flags);
+    put(time & 0xFF);
+    put(time >> 8);
+    put(mask);
+    put(things::width);
+
+    for (short index = 0; index < things::height; index++) {
+        if (mask & (1 << index)) {
+            for (short shift = bytes - 1; shift >= 0; shift--) {
+                put(pattern[index] >> (8 * shift));
+            }
+        }
+    }
+
+    if (flags & layered) {
+        for (short index = 0; index < 4; index++) {
+            put(segments[index]);
+        }
+    }
+
+    put(sum);
+
+    if (Serial.availableForWrite() < length) {
+        return;
+    }
+
+    Serial.write(buffer, length);
+
+    frame = pattern;
+    layer = segments;
+
+    count = (count + 1) % keys;
+}
+}  // namespace telemetry
+
+#endif
@@ -1,11 +1,22 @@
 #include "geometry.hpp"
 #include "things.hpp"
+#include "trace.hpp"
 
 #ifndef TETRIS_HPP
 #define TETRIS_HPP
 
 namespace tetris {
-canvas::frame frame;
+typedef canvas::frame<things::width, things::height> board;
+
+/**
+ * @brief Placement of a block, column of its center and rotation knob position
+ */
+struct placement {
+    short column;
+    short rotation;
+};
+
+board frame;
 
 geometry::object<4> block;
 
@@ -16,13 +27,24 @@ short level{};
 short steps{};
 short count{};
 short piece{};
-short score{};
+canvas::counter<4> score;
 
 bool change{};
 bool press{};
+bool planned{};
+
+short goal{};
+short dial{};
 
 short rotate[2]{};
 
+/**
+ * @brief Bytes of game state in RAM, listed along with globals above
+ */
+const short footprint = sizeof(frame) + sizeof(block) + sizeof(position) + sizeof(rotation) + sizeof(level) +
+                        sizeof(steps) + sizeof(count) + sizeof(piece) + sizeof(score) + sizeof(change) + sizeof(press) +
+                        sizeof(planned) + sizeof(goal) + sizeof(dial) + sizeof(rotate);
+
 void start();
 void generate();
 void read();
@@ -30,9 +52,17 @@ void draw();
 bool collision();
 void repos();
 bool verify();
+unsigned short result();
+short place(const board &, const geometry::object<4> &, short);
+placement search(const board &, const geometry::object<4> &, short);
+void plan();
+void pilot();
+void reset();
 void update(int);
 
-canvas::frame image({0b11111111, 0b10000001, 0b10100001, 0b10100001, 0b10101101, 0b10101101, 0b10000001, 0b11111111});
+const devices::note clear[] PROGMEM = {{523, 50}, {659, 50}, {784, 50}, {1047, 100}, {0, 0}};
+
+const byte image[8] PROGMEM = {0b11111111, 0b10000001, 0b10100001, 0b10100001, 0b10101101, 0b10101101, 0b10000001, 0b11111111};
 
 /**
  * @brief Start game
@@ -68,13 +98,13 @@ void generate() {
 void read() {
     press = bool(things::left.read() || things::right.read() || things::top.read() || things::bottom.read());
 
-    short current = things::first.read(0, 7);
+    short current = things::first.read(0, things::width - 1);
 
     short inferior = 0;
-    short superior = 7;
+    short superior = things::width - 1;
 
     for (auto &part : block) {
-        short edges[2][2] = {{0, 7}, {7, 0}};
+        short edges[2][2] = {{0, things::width - 1}, {things::width - 1, 0}};
 
         short line = part.get(true);
         short column = part.get(false);
@@ -85,7 +115,7 @@ void read() {
             }
         }
 
-        for (short superior = 7; superior > column; superior--) {
+        for (short superior = things::width - 1; superior > column; superior--) {
             if (frame.get(line, superior)) {
                 edges[0][1] = superior - 1;
             }
@@ -145,40 +175,49 @@ void read() {
  * @brief Draw game in screen and display
  */
 void draw() {
-    things::frame.set(block, true);
+    geometry::object<4> piece{block};
 
-    for (short index = 0; index < 8; index++) {
-        things::frame[index] |= frame[index];
+    while (not collision()) {
+        block.translate(1, 0);
     }
 
-    short points = score;
+    for (auto &part : block) {
+        things::shade.set(part, 1);
+    }
 
-    for (short index = 3; index > -1; index--) {
-        things::layer.set(index, points % 10);
+    block = piece;
 
-        points /= 10;
+    things::frame.set(block, true);
+
+    for (short index = 0; index < things::height; index++) {
+        things::frame[index] |= frame[index];
     }
+
+    score.write(things::layer, 0);
 }
 
 /**
  * @brief Verify collision
  *
+ * Block is moved one line down as a bitmask and tested against the board rows
+ *
  * @return Collision
  */
 bool collision() {
+    canvas::frame<things::width, things::height> below;
+
     for (auto &part : block) {
         short line = part.get(true);
         short column = part.get(false);
 
-        if (line == 7) {
-            return true;
-        }
-        if (frame.get(line + 1, column)) {
+        if (line == things::height - 1) {
             return true;
         }
+
+        below.set(line + 1, column, true);
     }
 
-    return false;
+    return below.overlap(frame);
 }
 
 /**
@@ -193,13 +232,17 @@ void repos() {
         if (collision()) {
             frame.set(block, true);
 
-            for (short position = 0; position < 8; position++) {
-                if (frame[position] == 255) {
+            for (short position = 0; position < things::height; position++) {
+                if (frame[position] == frame.full()) {
                     for (short index = position; index > 0; index--) {
                         frame[index] = frame[index - 1];
                     }
 
-                    score++;
+                    ++score;
+
+                    trace::mark(trace::line);
+
+                    things::buzzer.play(clear);
 
                     frame[0] = 0;
                 }
@@ -246,6 +289,172 @@ bool verify() {
     return false;
 }
 
+/**
+ * @brief Score of game
+ *
+ * @return Cleared lines, in BCD
+ */
+unsigned short result() {  //
+    return score.get();
+}
+
+/**
+ * @brief Evaluate a placement, block is dropped in a column and board rows are scored as bitmasks
+ *
+ * Weights of cleared lines, aggregate height and holes follow the classic heuristic players
+ *
+ * @param field Board where block lands
+ * @param shape Block in some rotation
+ * @param column Column to block center
+ * @return Placement value (-32768 if block does not fit in column)
+ */
+short place(const board &field, const geometry::object<4> &shape, short column) {
+    geometry::object<4> piece{shape};
+
+    piece.translate(0, column - piece[1].get(false));
+
+    short bottom = -things::height;
+
+    for (auto &part : piece) {
+        if (part.get(false) < 0 or part.get(false) > things::width - 1) {
+            return -32768;
+        }
+
+        bottom = max(bottom, part.get(true));
+    }
+
+    piece.translate(-bottom - 1, 0);
+
+    while (true) {
+        bool fits = true;
+
+        for (auto &part : piece) {
+            short line = part.get(true) + 1;
+
+            fits = fits and line < things::height and not field.get(line, part.get(false));
+        }
+
+        if (not fits) {
+            break;
+        }
+
+        piece.translate(1, 0);
+    }
+
+    board landed{field};
+
+    landed.set(piece, true);
+
+    short lines = 0;
+    short heights = 0;
+    short holes = 0;
+
+    board::row seen = 0;
+
+    for (short line = 0; line < things::height; line++) {
+        if (landed[line] == board::full()) {
+            lines++;
+            continue;
+        }
+
+        holes += numerics::ones(seen & ~landed[line]);
+        heights += numerics::ones(landed[line] & ~seen) * (things::height - line);
+
+        seen |= landed[line];
+    }
+
+    short value = 76 * lines - 51 * heights - 36 * holes;
+
+    for (auto &part : piece) {
+        if (part.get(true) < 0) {
+            value -= 10000;
+            break;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * @brief Search best placement of a block in all rotations and columns, reading no game state, so host tools can
+ * search boards in parallel
+ *
+ * @param field Board where block lands
+ * @param shape Block
+ * @param knob Rotation knob position of block
+ * @return Best placement (where block is, when none fits)
+ */
+placement search(const board &field, const geometry::object<4> &shape, short knob) {
+    placement choice{shape[1].get(false), knob};
+
+    short best = -32768;
+
+    for (short turn = 0; turn < 4; turn++) {
+        geometry::object<4> turned = geometry::orthos(shape, shape[1], turn);
+
+        for (short column = 0; column < things::width; column++) {
+            short value = place(field, turned, column);
+
+            if (value > best) {
+                best = value;
+
+                choice.column = column;
+                choice.rotation = (knob + turn) % 4;
+            }
+        }
+    }
+
+    return choice;
+}
+
+/**
+ * @brief Search best placement of current block
+ */
+void plan() {
+    placement choice = search(frame, block, rotate[1]);
+
+    goal = choice.column;
+    dial = choice.rotation;
+}
+
+/**
+ * @brief Automatic player, knobs walk to the planned placement and a button drops block
+ *
+ * Rotation knob moves one step by frame, so each step is a single quarter turn
+ */
+void pilot() {
+    if (change) {
+        planned = false;
+        return;
+    }
+
+    if (not planned) {
+        plan();
+
+        planned = true;
+    }
+
+    short knob = rotate[1];
+
+    if (knob != dial) {
+        knob += (knob < dial ? 1 : -1);
+    }
+
+    things::first.drive(goal, 0, things::width - 1);
+    things::second.drive(knob, 0, 3);
+
+    if (knob == dial and rotate[1] == dial and block[1].get(false) == goal) {
+        things::left.press();
+    }
+}
+
+/**
+ * @brief Reset scores kept between rounds
+ */
+void reset() {
+    score = 0;
+}
+
 /**
  * @brief Update game state
  *
@@ -1,6 +1,10 @@
 #include "canvas.hpp"
 #include "devices.hpp"
 
+#ifndef THINGS_LOCKSTEP
+#define THINGS_LOCKSTEP 0
+#endif
+
 #ifndef THINGS_HPP
 #define THINGS_HPP
 
@@ -26,24 +30,40 @@ const short firstPin = A2;
 const short secondPin = A3;
 
 const short period = 25;
+const short slot = 4;
+
+const short modules = 1;
+const short width = 8 * modules;
+const short height = 8;
+
+const long baud = 115200;
+
+const unsigned long idle = 30000;
+
+const bool profile = false;
+const bool telemetry = false;
+const bool monitor = false;
+const bool trace = false;
+const bool lockstep = THINGS_LOCKSTEP;
 
-devices::screen screen(inputScreenPin, clockScreenPin, loadScreenPin);
+devices::screen<modules> screen(inputScreenPin, clockScreenPin, loadScreenPin);
 
-devices::display display(inputDisplayPin, clockDisplayPin, timeDisplayValue);
+devices::display<inputDisplayPin, clockDisplayPin> display(timeDisplayValue);
 
 devices::knob level(levelPin);
 devices::knob bright(brightPin);
 devices::knob first(firstPin);
 devices::knob second(secondPin);
 
-devices::button left(leftPin);
-devices::button right(rightPin);
-devices::button top(topPin);
-devices::button bottom(bottomPin);
+devices::button<leftPin> left;
+devices::button<rightPin> right;
+devices::button<topPin> top;
+devices::button<bottomPin> bottom;
 
-devices::buzzer buzzer(buzzerPin);
+devices::buzzer<buzzerPin> buzzer;
 
-canvas::frame frame;
+canvas::frame<width, height> frame;
+canvas::planes<2, width, height> shade;
 canvas::layer layer;
 }  // namespace things
 
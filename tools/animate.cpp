@@ -0,0 +1,344 @@
+/**
+ * Export a telemetry capture from Serial as an animated GIF, keeping in
+ * memory only the frame being shown and merging identical frames in one
+ *
+ *     c++ -std=c++11 -O2 tools/animate.cpp -o animate
+ *     ./animate [scale] < capture.bin > session.gif
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "session.hpp"
+
+namespace gif {
+/**
+ * @class bits
+ * @brief Pack variable width codes in GIF data sub-blocks
+ *
+ */
+class bits {
+   private:
+    FILE *file;
+
+    uint8_t block[255];
+    unsigned length{};
+
+    uint32_t buffer{};
+    unsigned count{};
+
+    /**
+     * @brief Write a full byte in current sub-block
+     *
+     * @param data Byte
+     */
+    void put(uint8_t data) {
+        block[length++] = data;
+
+        if (length == sizeof(block)) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Write current sub-block
+     */
+    void flush() {
+        if (length) {
+            fputc(length, file);
+            fwrite(block, 1, length, file);
+        }
+
+        length = 0;
+    }
+
+   public:
+    /**
+     * @brief Initialize packer
+     *
+     * @param file Output file
+     */
+    bits(FILE *file) : file(file) {}
+
+    /**
+     * @brief Write a code
+     *
+     * @param code Code
+     * @param size Code width in bits
+     */
+    void write(unsigned code, unsigned size) {
+        buffer |= uint32_t(code) << count;
+        count += size;
+
+        while (count >= 8) {
+            put(buffer & 0xFF);
+
+            buffer >>= 8;
+            count -= 8;
+        }
+    }
+
+    /**
+     * @brief Write pending bits and block terminator
+     */
+    void close() {
+        if (count) {
+            put(buffer & 0xFF);
+        }
+
+        flush();
+        fputc(0, file);
+    }
+};
+
+/**
+ * @brief Write a 16 bit little endian number
+ *
+ * @param file Output file
+ * @param value Number
+ */
+void word(FILE *file, unsigned value) {
+    fputc(value & 0xFF, file);
+    fputc((value >> 8) & 0xFF, file);
+}
+
+/**
+ * @brief Write header with a black and red palette, looping forever
+ *
+ * @param file Output file
+ * @param width Width in pixels
+ * @param height Height in pixels
+ */
+void header(FILE *file, unsigned width, unsigned height) {
+    static const uint8_t palette[] = {0x10, 0x10, 0x10, 0xFF, 0x20, 0x20, 0, 0, 0, 0, 0, 0};
+
+    fwrite("GIF89a", 1, 6, file);
+
+    word(file, width);
+    word(file, height);
+
+    fputc(0xF1, file);  // global palette of 4 colors
+    fputc(0, file);
+    fputc(0, file);
+
+    fwrite(palette, 1, sizeof(palette), file);
+
+    fwrite("\x21\xFF\x0BNETSCAPE2.0\x03\x01\x00\x00\x00", 1, 19, file);
+}
+
+/**
+ * @brief Write an image compressed with LZW
+ *
+ * @param file Output file
+ * @param pixels Palette indexes
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param delay Delay in hundredths of second
+ */
+void image(FILE *file, const std::vector<uint8_t> &pixels, unsigned width, unsigned height, unsigned delay) {
+    const unsigned minimum = 2;
+    const unsigned clear = 1 << minimum;
+    const unsigned end = clear + 1;
+
+    fwrite("\x21\xF9\x04\x04", 1, 4, file);
+    word(file, delay);
+    fputc(0, file);
+    fputc(0, file);
+
+    fputc(0x2C, file);
+    word(file, 0);
+    word(file, 0);
+    word(file, width);
+    word(file, height);
+    fputc(0, file);
+
+    fputc(minimum, file);
+
+    std::unordered_map<uint32_t, unsigned> table;
+
+    bits stream(file);
+
+    unsigned size = minimum + 1;
+    unsigned next = end + 1;
+
+    stream.write(clear, size);
+
+    unsigned prefix = pixels[0];
+
+    for (size_t index = 1; index < pixels.size(); index++) {
+        uint32_t key = (prefix << 8) | pixels[index];
+
+        auto found = table.find(key);
+
+        if (found != table.end()) {
+            prefix = found->second;
+            continue;
+        }
+
+        stream.write(prefix, size);
+
+        if (next < 4096) {
+            if (next == (1u << size)) {
+                size++;
+            }
+
+            table[key] = next++;
+        } else {
+            stream.write(clear, size);
+
+            table.clear();
+
+            size = minimum + 1;
+            next = end + 1;
+        }
+
+        prefix = pixels[index];
+    }
+
+    stream.write(prefix, size);
+    stream.write(end, size);
+    stream.close();
+}
+}  // namespace gif
+
+/**
+ * @class exporter
+ * @brief Hold the frame being shown until a different one arrives
+ *
+ */
+class exporter {
+   private:
+    FILE *file;
+
+    unsigned scale;
+
+    session::state shown;
+    bool pending{false};
+
+    unsigned width{};
+    unsigned height{};
+
+    unsigned long written{};  // Centiseconds written
+    unsigned long frames{};
+
+    /**
+     * @brief Write shown frame until a moment
+     *
+     * @param time Moment in milliseconds
+     */
+    void emit(unsigned long time) {
+        std::vector<uint8_t> pixels(width * height);
+
+        unsigned columns = shown.width;
+
+        for (unsigned line = 0; line < height; line++) {
+            for (unsigned column = 0; column < width; column++) {
+                unsigned row = line / scale;
+                unsigned bit = column / scale;
+
+                bool inner = line % scale and column % scale;
+                bool lit = (shown.rows[row] >> (columns - 1 - bit)) & 1;
+
+                pixels[line * width + column] = inner and lit;
+            }
+        }
+
+        unsigned long target = time / 10;
+
+        while (written < target) {
+            unsigned delay = target - written < 0xFFFF ? target - written : 0xFFFF;
+
+            gif::image(file, pixels, width, height, delay);
+
+            written += delay;
+            frames++;
+        }
+    }
+
+   public:
+    /**
+     * @brief Initialize exporter
+     *
+     * @param file Output file
+     * @param scale Pixels by led
+     */
+    exporter(FILE *file, unsigned scale) : file(file), scale(scale) {}
+
+    /**
+     * @brief Account a decoded frame
+     *
+     * @param frame Frame state
+     */
+    void add(const session::state &frame) {
+        if (not pending) {
+            width = frame.width * scale;
+            height = 8 * scale;
+
+            gif::header(file, width, height);
+
+            shown = frame;
+            pending = true;
+
+            return;
+        }
+
+        if (memcmp(shown.rows, frame.rows, sizeof(frame.rows)) == 0) {
+            return;
+        }
+
+        emit(frame.time);
+
+        shown = frame;
+    }
+
+    /**
+     * @brief Write last frame and trailer
+     *
+     * @param time Moment of end of session
+     * @return Amount of images written
+     */
+    unsigned long close(unsigned long time) {
+        if (not pending) {
+            return 0;
+        }
+
+        emit(time > shown.time + 1000 ? time : shown.time + 1000);
+
+        fputc(0x3B, file);
+
+        return frames;
+    }
+};
+
+int main(int argc, char **argv) {
+    unsigned scale = argc > 1 ? atoi(argv[1]) : 16;
+
+    if (scale < 2) {
+        scale = 2;
+    }
+
+    session::decoder decoder;
+    exporter output(stdout, scale);
+
+    unsigned long last = 0;
+    unsigned long count = 0;
+
+    int data;
+
+    while ((data = getchar()) != EOF) {
+        if (decoder.feed(data)) {
+            output.add(decoder.get());
+
+            last = decoder.get().time;
+            count++;
+        }
+    }
+
+    unsigned long frames = output.close(last);
+
+    fprintf(stderr, "%lu packets, %lu images\n", count, frames);
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "../host.hpp"
+
+#ifndef EEPROM_H
+#define EEPROM_H
+
+/**
+ * EEPROM stand-in for host (see host.hpp), a byte write keeps it busy for 3.3 ms as on Uno
+ */
+namespace host {
+const short capacity = 1024;
+
+byte eeprom[capacity];
+unsigned long busy{};  // Moment EEPROM is ready again
+
+/**
+ * @brief Erase EEPROM, as a new board has it
+ */
+void erase() {  //
+    memset(eeprom, 0xFF, sizeof(eeprom));
+}
+}  // namespace host
+
+inline bool eeprom_is_ready() {  //
+    return host::clock >= host::busy;
+}
+
+inline byte eeprom_read_byte(const byte *address) {
+    host::charge(host::cost.eeprom);
+
+    return host::eeprom[reinterpret_cast<uintptr_t>(address) % host::capacity];
+}
+
+inline void eeprom_write_byte(byte *address, byte value) {
+    host::charge(host::cost.eeprom);
+
+    while (not eeprom_is_ready()) {
+        host::charge(1000);
+    }
+
+    host::eeprom[reinterpret_cast<uintptr_t>(address) % host::capacity] = value;
+    host::busy = host::clock + 3300;
+}
+
+inline void eeprom_read_block(void *destination, const void *source, size_t length) {
+    for (size_t index = 0; index < length; index++) {
+        static_cast<byte *>(destination)[index] = eeprom_read_byte(static_cast<const byte *>(source) + index);
+    }
+}
+
+#endif
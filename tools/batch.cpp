@@ -0,0 +1,1135 @@
+/**
+ * Step many snake or tetris games at once in host, for automatic player search and fuzzing. Lanes are kept as
+ * structure of arrays and boards as 64-bit masks, so occupancy, piece masks and collision tests are bitwise, and
+ * loops over lanes are vectorized by the compiler (AVX2 with -march=native)
+ *
+ *     c++ -std=gnu++11 -fpermissive -O3 -march=native tools/batch.cpp -o batch
+ *     ./batch snake|tetris [TICKS] [check=LANES]
+ *
+ * Each lane plays on its own stream of random inputs (knobs jumping and bursts of buttons), restarting on defeat,
+ * in level given by lane modulo 4. First LANES lanes (64 by default) are checked against scalar snake:: and tetris::
+ * each tick, played in child processes on same inputs, comparing a hash of state as equivalence does. Then all lanes
+ * are stepped TICKS ticks (10000 by default) and game steps per second are reported as a JSON line.
+ *
+ * Time is simulated with calls costing nothing (see host.hpp), lane l at tick t being at 1000 l + 25000 (t + 1)
+ * microseconds, and analog pin 0 reads zero, so seeds taken by numerics::seed are known.
+ */
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include "host.hpp"
+
+#include "../snake.hpp"
+#include "../tetris.hpp"
+
+const short width = things::width;
+const short height = things::height;
+const short cells = width * height;
+
+static_assert(cells <= 64, "Board must fit in 64 bits");
+
+const long lanes = 4096;
+
+typedef uint64_t board;
+
+namespace batch {
+/**
+ * @brief Inputs of a tick in a lane
+ */
+struct input {
+    short first;
+    short second;
+    byte buttons;
+};
+
+/**
+ * @class digest
+ * @brief FNV-1a hash of values
+ *
+ */
+class digest {
+   private:
+    uint32_t value{2166136261u};
+
+   public:
+    /**
+     * @brief Add a value
+     *
+     * @param number Value
+     */
+    void add(long number) {
+        for (short index = 0; index < 4; index++) {
+            value = (value ^ byte(number >> (8 * index))) * 16777619u;
+        }
+    }
+
+    /**
+     * @brief Hash of values added
+     *
+     * @return Hash
+     */
+    uint32_t get() const {  //
+        return value;
+    }
+};
+
+/**
+ * @brief Random number as host random does, only the low 32 bits of its state are ever read
+ *
+ * @param state Generator state
+ * @param maximum Upper bound (excluded)
+ * @return Random number
+ */
+inline long random(uint32_t &state, long maximum) {
+    state = state * 1103515245u + 12345u;
+
+    return maximum > 0 ? long((state >> 16) & 0x7FFF) % maximum : 0;
+}
+
+/**
+ * @brief Simulated time of a lane in a tick
+ *
+ * @param lane Lane
+ * @param tick Tick
+ * @return Microseconds
+ */
+inline uint32_t moment(long lane, long tick) {  //
+    return 1000ul * lane + 1000ul * things::period * (tick + 1);
+}
+
+/**
+ * @brief Generator state left by numerics::seed at a time
+ *
+ * @param time Microseconds
+ * @return Generator state
+ */
+uint32_t seed(uint32_t time) {
+    uint32_t state = time + time / 1000;
+
+    if (state == 0) {
+        state = 1;
+    }
+
+    long value = time > 1 ? 1 + random(state, time - 1) : 1;
+
+    return value ? value : 1;
+}
+
+/**
+ * @brief Next inputs of a stream, knobs jump now and then and buttons come in bursts
+ *
+ * @param state Stream generator state
+ * @param value Inputs, updated
+ */
+inline void feed(uint32_t &state, input &value) {
+    long noise = random(state, 0x8000);
+
+    value.buttons = (noise & 0x70) == 0 ? noise & 0xF : 0;
+
+    if ((noise & 0x780) == 0) {
+        value.first = random(state, 1024);
+    }
+    if ((noise & 0x3800) == 0) {
+        value.second = random(state, 1024);
+    }
+}
+
+/**
+ * @brief Mask of a cell in a board
+ *
+ * @param line Line
+ * @param column Column
+ * @return Mask (none if outside board)
+ */
+inline board bit(short line, short column) {
+    bool inside = (unsigned short)line < height and (unsigned short)column < width;
+
+    return board(inside) << ((line * width + width - 1 - column) & 63);
+}
+
+/**
+ * @brief Mask of lowest bits
+ *
+ * @param count Bits
+ * @return Mask
+ */
+inline board below(short count) {  //
+    return count >= 64 ? ~board(0) : (board(1) << count) - 1;
+}
+
+/**
+ * @brief Row of a board, as canvas::frame keeps it
+ *
+ * @param value Board
+ * @param line Line
+ * @return Row (empty if outside board)
+ */
+inline board row(board value, short line) {  //
+    return line >= 0 and line < height ? (value >> (line * width)) & below(width) : 0;
+}
+
+/**
+ * @brief Value of a canvas::counter after some increments, in BCD
+ *
+ * @param count Increments
+ * @param digits Digits
+ * @return Value
+ */
+unsigned short decimal(long count, short digits) {
+    long limit = 1;
+
+    for (short index = 0; index < digits; index++) {
+        limit *= 10;
+    }
+
+    count = min(count, limit - 1);
+
+    unsigned short value = 0;
+
+    for (short index = 0; index < digits; index++, count /= 10) {
+        value |= (count % 10) << (4 * index);
+    }
+
+    return value;
+}
+
+uint32_t noises[lanes];
+input inputs[lanes];
+bool restarts[lanes];
+
+/**
+ * @brief Reset inputs of all lanes
+ */
+void begin() {
+    for (long lane = 0; lane < lanes; lane++) {
+        noises[lane] = 1 + lane;
+        inputs[lane] = {512, 0, 0};
+        restarts[lane] = true;
+    }
+}
+
+namespace snake {
+short lines[lanes];  // Head
+short columns[lanes];
+short foods[lanes];  // Food, as line * width + column
+signed char senses[2][lanes];
+
+signed char turns[2][3][lanes];
+byte pending[lanes];
+
+uint16_t body[cells][lanes];  // Ring of parts as packed line and column, head at front
+short fronts[lanes];
+short lengths[lanes];
+board occupied[lanes];  // Parts inside board
+
+short levels[lanes];
+short steps[lanes];
+short counts[lanes];
+short points[lanes];
+uint32_t states[lanes];
+
+bool defeats[lanes];
+
+/**
+ * @brief Pack a point in a ring entry
+ *
+ * @param line Line
+ * @param column Column
+ * @return Entry
+ */
+inline uint16_t pack(short line, short column) {  //
+    return uint16_t(byte(line) << 8 | byte(column));
+}
+
+/**
+ * @brief Part of a lane, from head
+ *
+ * @param lane Lane
+ * @param index Part index
+ * @param line Line, set
+ * @param column Column, set
+ */
+inline void part(long lane, short index, short &line, short &column) {
+    uint16_t value = body[(fronts[lane] + index) % cells][lane];
+
+    line = static_cast<signed char>(value >> 8);
+    column = static_cast<signed char>(value & 0xFF);
+}
+
+/**
+ * @brief Reset all lanes
+ */
+void clear() {
+    memset(lines, 0, sizeof(lines));
+    memset(columns, 0, sizeof(columns));
+    memset(foods, 0, sizeof(foods));
+    memset(senses, 0, sizeof(senses));
+    memset(turns, 0, sizeof(turns));
+    memset(pending, 0, sizeof(pending));
+    memset(body, 0, sizeof(body));
+    memset(fronts, 0, sizeof(fronts));
+    memset(lengths, 0, sizeof(lengths));
+    memset(occupied, 0, sizeof(occupied));
+    memset(levels, 0, sizeof(levels));
+    memset(steps, 0, sizeof(steps));
+    memset(counts, 0, sizeof(counts));
+    memset(points, 0, sizeof(points));
+    memset(defeats, 0, sizeof(defeats));
+
+    for (uint32_t &state : states) {
+        state = 1;
+    }
+}
+
+/**
+ * @brief Place food away from body, as snake::change does
+ *
+ * @param lane Lane
+ */
+void change(long lane) {
+    while (true) {
+        short column = random(states[lane], width);
+        short line = random(states[lane], height);
+
+        foods[lane] = line * width + column;
+
+        if (not(occupied[lane] & bit(line, column))) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Start a lane, as snake::start does (its read advances count, and its move is undone)
+ *
+ * @param lane Lane
+ * @param tick Tick
+ */
+void start(long lane, long tick) {
+    steps[lane] = 20 - 4 * levels[lane];
+    counts[lane] = 1 + counts[lane] % steps[lane];
+
+    uint32_t &state = states[lane];
+
+    state = seed(moment(lane, tick));
+
+    short line = height / 2 - 1 + random(state, 2);
+    short column = width / 2 - 1 + random(state, 2);
+
+    short food = random(state, width);
+
+    foods[lane] = random(state, height) * width + food;
+
+    lines[lane] = line;
+    columns[lane] = column;
+    senses[0][lane] = 0;
+    senses[1][lane] = 0;
+    pending[lane] = 0;
+
+    fronts[lane] = 0;
+    lengths[lane] = 1;
+    body[0][lane] = pack(line, column);
+    occupied[lane] = bit(line, column);
+
+    points[lane] = 1;
+}
+
+/**
+ * @brief Queue a change of sense, as snake::turn does
+ *
+ * @param lane Lane
+ * @param line Vertical sense
+ * @param column Horizontal sense
+ */
+inline void turn(long lane, short line, short column) {
+    short count = pending[lane];
+
+    if (count == 3) {
+        return;
+    }
+
+    short last = count ? turns[0][count - 1][lane] : senses[0][lane];
+    short other = count ? turns[1][count - 1][lane] : senses[1][lane];
+
+    bool stopped = last == 0 and other == 0;
+    bool across = (line != 0) != (last != 0);
+
+    if (not(stopped or across)) {
+        return;
+    }
+
+    turns[0][count][lane] = line;
+    turns[1][count][lane] = column;
+    pending[lane] = count + 1;
+}
+
+/**
+ * @brief Move a lane, as snake::repos does when count reaches steps, and verify defeat
+ *
+ * @param lane Lane
+ */
+void move(long lane) {
+    if (pending[lane]) {
+        senses[0][lane] = turns[0][0][lane];
+        senses[1][lane] = turns[1][0][lane];
+
+        for (short index = 1; index < pending[lane]; index++) {
+            turns[0][index - 1][lane] = turns[0][index][lane];
+            turns[1][index - 1][lane] = turns[1][index][lane];
+        }
+
+        pending[lane]--;
+    }
+
+    short length = lengths[lane];
+
+    short tail;
+    short end;
+
+    part(lane, length - 1, tail, end);
+
+    short line = lines[lane] + senses[0][lane];
+    short column = columns[lane] + senses[1][lane];
+
+    lines[lane] = line;
+    columns[lane] = column;
+
+    fronts[lane] = (fronts[lane] + cells - 1) % cells;
+    body[fronts[lane]][lane] = pack(line, column);
+
+    bool eaten = line * width + column == foods[lane] and bit(line, column);
+
+    board rest = eaten ? occupied[lane] : occupied[lane] & ~bit(tail, end);
+
+    bool bitten = rest & bit(line, column);
+
+    occupied[lane] = rest | bit(line, column);
+
+    if (eaten) {
+        change(lane);
+
+        lengths[lane] = ++length;
+        points[lane]++;
+    }
+
+    short neck = column;
+
+    if (length > 1) {
+        short other;
+
+        part(lane, 1, other, neck);
+    }
+
+    defeats[lane] = bitten or line < 0 or line > height - 1 or neck < 0 or neck > width - 1;
+}
+
+/**
+ * @brief Step all lanes a tick, as engine does (start on defeat, then update and verify)
+ *
+ * @param tick Tick
+ */
+void step(long tick) {
+    for (long lane = 0; lane < lanes; lane++) {
+        feed(noises[lane], inputs[lane]);
+    }
+
+    for (long lane = 0; lane < lanes; lane++) {
+        if (restarts[lane]) {
+            start(lane, tick);
+        }
+    }
+
+    for (long lane = 0; lane < lanes; lane++) {
+        byte buttons = inputs[lane].buttons;
+
+        if (buttons & 1) {
+            turn(lane, 0, -1);
+        }
+        if (buttons & 8) {
+            turn(lane, 0, 1);
+        }
+        if (buttons & 4) {
+            turn(lane, -1, 0);
+        }
+        if (buttons & 2) {
+            turn(lane, 1, 0);
+        }
+    }
+
+    for (long lane = 0; lane < lanes; lane++) {
+        levels[lane] = lane % 4;
+        steps[lane] = 20 - 4 * levels[lane];
+        counts[lane] = 1 + counts[lane] % steps[lane];
+        defeats[lane] = false;
+    }
+
+    for (long lane = 0; lane < lanes; lane++) {
+        if (counts[lane] == steps[lane]) {
+            move(lane);
+        }
+    }
+
+    for (long lane = 0; lane < lanes; lane++) {
+        restarts[lane] = defeats[lane];
+    }
+}
+
+/**
+ * @brief Hash of a lane, as equivalence takes it on snake::
+ *
+ * @param lane Lane
+ * @return Hash
+ */
+uint32_t hash(long lane) {
+    digest state;
+
+    for (short index = 0; index < lengths[lane]; index++) {
+        short line;
+        short column;
+
+        part(lane, index, line, column);
+
+        state.add(line);
+        state.add(column);
+    }
+    for (short index = 0; index < pending[lane]; index++) {
+        state.add(turns[0][index][lane]);
+        state.add(turns[1][index][lane]);
+    }
+
+    long values[] = {foods[lane] / width, foods[lane] % width, senses[0][lane], senses[1][lane], lengths[lane],
+                     pending[lane], levels[lane], steps[lane], counts[lane], decimal(points[lane], 2),
+                     states[lane], restarts[lane]};
+
+    for (long value : values) {
+        state.add(value);
+    }
+
+    return state.get();
+}
+
+/**
+ * @brief Hash of scalar snake, in same order
+ *
+ * @param defeat Defeat
+ * @return Hash
+ */
+uint32_t scalar(bool defeat) {
+    digest state;
+
+    for (short index = 0; index < ::snake::length; index++) {
+        state.add(::snake::body[index].get(true));
+        state.add(::snake::body[index].get(false));
+    }
+    for (short index = 0; index < ::snake::pending; index++) {
+        state.add(::snake::turns[index].get(true));
+        state.add(::snake::turns[index].get(false));
+    }
+
+    long values[] = {::snake::food.get(true),  ::snake::food.get(false), ::snake::sense.get(true),
+                     ::snake::sense.get(false), ::snake::length,        ::snake::pending,
+                     ::snake::level,            ::snake::steps,         ::snake::count,
+                     ::snake::points.get(),     uint32_t(host::state),  defeat};
+
+    for (long value : values) {
+        state.add(value);
+    }
+
+    return state.get();
+}
+}  // namespace snake
+
+namespace tetris {
+short lines[4][lanes];  // Block parts
+short columns[4][lanes];
+board frames[lanes];
+
+short positions[lanes];
+short rotations[lanes];
+short dials[2][lanes];  // As tetris::rotate
+short pieces[lanes];
+
+short levels[lanes];
+short steps[lanes];
+short counts[lanes];
+long scores[lanes];
+bool changes[lanes];
+bool presses[lanes];
+uint32_t states[lanes];
+
+short inferiors[lanes];  // Bounds of position in a tick
+short superiors[lanes];
+short shifts[lanes];
+bool hits[lanes];   // Block collides one line down
+bool landed[lanes];  // Block landed in a tick
+
+short walls[2][width + 1][1 << width];  // Nearest walls in a row, to the left of a column and from a column on
+
+/**
+ * @brief Find nearest walls in each row, as tetris::read scans columns
+ */
+void build() {
+    for (short column = 0; column <= width; column++) {
+        for (short cells = 0; cells < 1 << width; cells++) {
+            short first = 0;
+            short last = width - 1;
+
+            for (short other = 0; other < column; other++) {
+                if (cells & (1 << (width - 1 - other))) {
+                    first = other + 1;
+                }
+            }
+
+            for (short other = width - 1; other >= column; other--) {
+                if (cells & (1 << (width - 1 - other))) {
+                    last = other - 1;
+                }
+            }
+
+            walls[0][column][cells] = first;
+            walls[1][column][cells] = last;
+        }
+    }
+}
+
+/**
+ * @brief Reset all lanes
+ */
+void clear() {
+    memset(lines, 0, sizeof(lines));
+    memset(columns, 0, sizeof(columns));
+    memset(frames, 0, sizeof(frames));
+    memset(positions, 0, sizeof(positions));
+    memset(rotations, 0, sizeof(rotations));
+    memset(dials, 0, sizeof(dials));
+    memset(pieces, 0, sizeof(pieces));
+    memset(levels, 0, sizeof(levels));
+    memset(steps, 0, sizeof(steps));
+    memset(counts, 0, sizeof(counts));
+    memset(scores, 0, sizeof(scores));
+    memset(changes, 0, sizeof(changes));
+    memset(presses, 0, sizeof(presses));
+
+    for (uint32_t &state : states) {
+        state = 1;
+    }
+
+    build();
+}
+
+/**
+ * @brief Verify collision of block one line down, as tetris::collision does
+ *
+ * @param lane Lane
+ * @return Collision
+ */
+inline bool collision(long lane) {
+    board mask = 0;
+    bool floor = false;
+
+    for (short index = 0; index < 4; index++) {
+        short line = lines[index][lane];
+
+        floor |= line == height - 1;
+        mask |= bit(line + 1, columns[index][lane]);
+    }
+
+    return floor | ((mask & frames[lane]) != 0);
+}
+
+/**
+ * @brief Verify collision of blocks in all lanes
+ */
+void collide() {
+    for (long lane = 0; lane < lanes; lane++) {
+        hits[lane] = collision(lane);
+    }
+}
+
+/**
+ * @brief Rotate block around its second part, as geometry::orthos does
+ *
+ * @param lane Lane
+ * @param angle Quarter turns
+ */
+inline void orthos(long lane, short angle) {
+    angle = abs(angle) % 4;
+
+    short sine = angle == 1 ? 1 : angle == 3 ? -1 : 0;
+    short cosine = angle == 0 ? 1 : angle == 2 ? -1 : 0;
+
+    short vertical = lines[1][lane];
+    short horizontal = columns[1][lane];
+
+    for (short index = 0; index < 4; index++) {
+        short column = columns[index][lane] - horizontal;
+        short line = lines[index][lane] - vertical;
+
+        lines[index][lane] = column * sine + line * cosine + vertical;
+        columns[index][lane] = column * cosine - line * sine + horizontal;
+    }
+}
+
+/**
+ * @brief Spawn a piece above board, as tetris::generate does and tetris::read then shifts it
+ *
+ * @param lane Lane
+ */
+void generate(long lane) {
+    static const short shapes[2][7][4] = {
+        {{0, 0, 0, 0}, {0, 0, 0, 1}, {0, 0, 0, 1}, {0, 0, 0, 1}, {0, 0, 1, 1}, {1, 0, 0, 1}, {0, 0, 1, 1}},
+        {{-1, 0, 1, 2}, {-1, 0, 1, -1}, {-1, 0, 1, 0}, {-1, 0, 1, 1}, {-1, 0, 0, 1}, {-1, 0, 1, 0}, {-1, 0, -1, 0}}};
+
+    short piece = random(states[lane], 7);
+
+    pieces[lane] = piece;
+
+    for (short index = 0; index < 4; index++) {
+        lines[index][lane] = shapes[0][piece][index];
+        columns[index][lane] = shapes[1][piece][index];
+    }
+
+    orthos(lane, 4 - dials[0][lane]);
+
+    short shift = 0;
+
+    for (short index = 0; index < 4; index++) {
+        shift = max(shift, lines[index][lane]);
+    }
+
+    for (short index = 0; index < 4; index++) {
+        lines[index][lane] -= shift + 1;
+    }
+}
+
+/**
+ * @brief Read knobs and buttons of all lanes, as tetris::read does
+ *
+ * Walls around each part are looked up by its board row, instead of scanning columns
+ */
+void read() {
+    for (long lane = 0; lane < lanes; lane++) {
+        presses[lane] = inputs[lane].buttons != 0;
+
+        inferiors[lane] = 0;
+        superiors[lane] = width - 1;
+    }
+
+    for (short index = 0; index < 4; index++) {
+        for (long lane = 0; lane < lanes; lane++) {
+            short line = lines[index][lane];
+            short column = columns[index][lane];
+
+            short cells = row(frames[lane], line);
+
+            short first = walls[0][max(short(0), min(column, width))][cells];
+            short last = walls[1][max(short(0), min(short(column + 1), width))][cells];
+
+            inferiors[lane] = max(inferiors[lane], positions[lane] + first - min(column, short(width - 1)));
+            superiors[lane] = min(superiors[lane], positions[lane] + last - max(column, short(0)));
+        }
+    }
+
+    for (long lane = 0; lane < lanes; lane++) {
+        short position = map(inputs[lane].first, 0, 1023, 0, width - 1);
+
+        position = position < inferiors[lane] ? inferiors[lane] : position;
+        position = position > superiors[lane] ? superiors[lane] : position;
+
+        positions[lane] = position;
+
+        short dial = map(inputs[lane].second, 0, 1023, 0, 3);
+
+        rotations[lane] = dial == dials[1][lane] ? 0 : dial < dials[1][lane] ? 3 : 1;
+
+        dials[0][lane] = dial;
+        dials[1][lane] = dial;
+    }
+
+    for (long lane = 0; lane < lanes; lane++) {
+        if (changes[lane]) {
+            generate(lane);
+
+            changes[lane] = false;
+        }
+    }
+}
+
+/**
+ * @brief Land block of a lane and clear full lines, as tetris::repos does on collision
+ *
+ * @param lane Lane
+ */
+void land(long lane) {
+    board value = frames[lane];
+
+    for (short index = 0; index < 4; index++) {
+        value |= bit(lines[index][lane], columns[index][lane]);
+    }
+
+    for (short line = 0; line < height; line++) {
+        if (row(value, line) == below(width)) {
+            value = (value & ~below((line + 1) * width)) | ((value & below(line * width)) << width);
+
+            scores[lane]++;
+        }
+    }
+
+    frames[lane] = value;
+    changes[lane] = true;
+}
+
+/**
+ * @brief Move blocks of all lanes, as tetris::repos does
+ */
+void repos() {
+    for (long lane = 0; lane < lanes; lane++) {
+        shifts[lane] = positions[lane] - columns[1][lane];
+    }
+
+    for (short index = 0; index < 4; index++) {
+        for (long lane = 0; lane < lanes; lane++) {
+            columns[index][lane] += shifts[lane];
+        }
+    }
+
+    collide();
+
+    for (long lane = 0; lane < lanes; lane++) {
+        landed[lane] = counts[lane] == steps[lane] and hits[lane];
+
+        if (landed[lane]) {
+            land(lane);
+        }
+    }
+
+    for (short index = 0; index < 4; index++) {
+        for (long lane = 0; lane < lanes; lane++) {
+            lines[index][lane] += counts[lane] == steps[lane] and not hits[lane];
+        }
+    }
+
+    for (long lane = 0; lane < lanes; lane++) {
+        orthos(lane, landed[lane] ? 0 : rotations[lane]);
+    }
+
+    for (long lane = 0; lane < lanes; lane++) {
+        if (presses[lane] and not landed[lane]) {
+            while (not collision(lane)) {
+                for (short index = 0; index < 4; index++) {
+                    lines[index][lane]++;
+                }
+            }
+
+            presses[lane] = false;
+        }
+    }
+}
+
+/**
+ * @brief Step all lanes a tick, as engine does (start on defeat, then update and verify)
+ *
+ * @param tick Tick
+ */
+void step(long tick) {
+    for (long lane = 0; lane < lanes; lane++) {
+        feed(noises[lane], inputs[lane]);
+    }
+
+    for (long lane = 0; lane < lanes; lane++) {
+        if (restarts[lane]) {
+            states[lane] = seed(moment(lane, tick));
+            frames[lane] = 0;
+            changes[lane] = true;
+        }
+    }
+
+    read();
+
+    for (long lane = 0; lane < lanes; lane++) {
+        levels[lane] = lane % 4;
+        steps[lane] = 20 - 4 * levels[lane];
+        counts[lane] = counts[lane] < steps[lane] ? counts[lane] + 1 : 1 + counts[lane] % steps[lane];
+    }
+
+    repos();
+    collide();
+
+    for (long lane = 0; lane < lanes; lane++) {
+        bool above = false;
+
+        for (short index = 0; index < 4; index++) {
+            above = above or lines[index][lane] < 0;
+        }
+
+        restarts[lane] = counts[lane] == steps[lane] and hits[lane] and above;
+    }
+}
+
+/**
+ * @brief Hash of a lane, as equivalence takes it on tetris::
+ *
+ * @param lane Lane
+ * @return Hash
+ */
+uint32_t hash(long lane) {
+    digest state;
+
+    state.add(frames[lane]);
+    state.add(frames[lane] >> 32);
+
+    for (short index = 0; index < 4; index++) {
+        state.add(lines[index][lane]);
+        state.add(columns[index][lane]);
+    }
+
+    long values[] = {positions[lane], rotations[lane], levels[lane],       steps[lane],
+                     counts[lane],    pieces[lane],    decimal(scores[lane], 4), changes[lane],
+                     presses[lane],   dials[0][lane],  dials[1][lane],     states[lane],
+                     restarts[lane]};
+
+    for (long value : values) {
+        state.add(value);
+    }
+
+    return state.get();
+}
+
+/**
+ * @brief Hash of scalar tetris, in same order
+ *
+ * @param defeat Defeat
+ * @return Hash
+ */
+uint32_t scalar(bool defeat) {
+    digest state;
+    board value = 0;
+
+    for (short line = 0; line < height; line++) {
+        value |= board(::tetris::frame[line]) << (line * width);
+    }
+
+    state.add(value);
+    state.add(value >> 32);
+
+    for (auto &part : ::tetris::block) {
+        state.add(part.get(true));
+        state.add(part.get(false));
+    }
+
+    long values[] = {::tetris::position, ::tetris::rotation,   ::tetris::level,       ::tetris::steps,
+                     ::tetris::count,    ::tetris::piece,      ::tetris::score.get(), ::tetris::change,
+                     ::tetris::press,    ::tetris::rotate[0],  ::tetris::rotate[1],   uint32_t(host::state),
+                     defeat};
+
+    for (long value : values) {
+        state.add(value);
+    }
+
+    return state.get();
+}
+}  // namespace tetris
+}  // namespace batch
+
+/**
+ * @brief Entry points of a game, scalar and batched
+ */
+struct game {
+    const char *name;
+
+    void (*start)();
+    void (*update)(int);
+    bool (*verify)();
+    uint32_t (*scalar)(bool);
+
+    void (*clear)();
+    void (*step)(long);
+    uint32_t (*hash)(long);
+};
+
+const game kinds[] = {
+    {"snake", snake::start, snake::update, snake::verify, batch::snake::scalar, batch::snake::clear,
+     batch::snake::step, batch::snake::hash},
+    {"tetris", tetris::start, tetris::update, tetris::verify, batch::tetris::scalar, batch::tetris::clear,
+     batch::tetris::step, batch::tetris::hash},
+};
+
+/**
+ * @brief Play a lane in scalar game, in a child process so it starts from pristine state
+ *
+ * @param kind Game
+ * @param lane Lane
+ * @param ticks Ticks
+ * @return Hash by tick
+ */
+std::vector<uint32_t> play(const game &kind, long lane, long ticks) {
+    int ends[2];
+
+    if (pipe(ends) < 0) {
+        perror("pipe");
+        exit(2);
+    }
+
+    fflush(stdout);
+
+    pid_t child = fork();
+
+    if (child == 0) {
+        close(ends[0]);
+
+        uint32_t noise = 1 + lane;
+        batch::input value{512, 0, 0};
+        bool restart = true;
+
+        for (long tick = 0; tick < ticks; tick++) {
+            batch::feed(noise, value);
+
+            host::clock = batch::moment(lane, tick);
+
+            if (restart) {
+                kind.start();
+            }
+
+            things::frame.clear();
+            things::shade.clear();
+            things::layer.clear();
+
+            things::left.read();
+            things::right.read();
+            things::top.read();
+            things::bottom.read();
+
+            if (value.buttons & 1) {
+                things::left.press();
+            }
+            if (value.buttons & 2) {
+                things::right.press();
+            }
+            if (value.buttons & 4) {
+                things::top.press();
+            }
+            if (value.buttons & 8) {
+                things::bottom.press();
+            }
+
+            things::first.drive(value.first, 0, 1023);
+            things::second.drive(value.second, 0, 1023);
+
+            kind.update(lane % 4);
+
+            restart = kind.verify();
+
+            uint32_t hash = kind.scalar(restart);
+
+            if (write(ends[1], &hash, sizeof(hash)) != sizeof(hash)) {
+                _exit(2);
+            }
+        }
+
+        _exit(0);
+    }
+
+    close(ends[1]);
+
+    std::vector<uint32_t> hashes;
+    uint32_t hash;
+
+    while (read(ends[0], &hash, sizeof(hash)) == sizeof(hash)) {
+        hashes.push_back(hash);
+    }
+
+    close(ends[0]);
+    waitpid(child, nullptr, 0);
+
+    return hashes;
+}
+
+/**
+ * @brief Check first lanes of batch against scalar game, each tick
+ *
+ * @param kind Game
+ * @param count Lanes checked
+ * @param ticks Ticks
+ * @return If all agree
+ */
+bool check(const game &kind, long count, long ticks) {
+    std::vector<std::vector<uint32_t>> hashes;
+
+    for (long lane = 0; lane < count; lane++) {
+        hashes.push_back(play(kind, lane, ticks));
+    }
+
+    batch::begin();
+    kind.clear();
+
+    for (long tick = 0; tick < ticks; tick++) {
+        kind.step(tick);
+
+        for (long lane = 0; lane < count; lane++) {
+            if (tick >= long(hashes[lane].size()) or kind.hash(lane) != hashes[lane][tick]) {
+                printf("# %s lane %ld diverges at tick %ld\n", kind.name, lane, tick);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    typedef std::chrono::steady_clock watch;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s snake|tetris [TICKS] [check=LANES]\n", argv[0]);
+        return 2;
+    }
+
+    const game *kind = nullptr;
+
+    for (const game &item : kinds) {
+        if (strcmp(argv[1], item.name) == 0) {
+            kind = &item;
+        }
+    }
+
+    if (not kind) {
+        fprintf(stderr, "unknown game %s\n", argv[1]);
+        return 2;
+    }
+
+    long ticks = 10000;
+    long count = 64;
+
+    for (int index = 2; index < argc; index++) {
+        if (strncmp(argv[index], "check=", 6) == 0) {
+            count = min(atol(argv[index] + 6), lanes);
+        } else {
+            ticks = atol(argv[index]);
+        }
+    }
+
+    host::freeze();
+
+    if (not check(*kind, count, ticks)) {
+        return 1;
+    }
+
+    batch::begin();
+    kind->clear();
+
+    watch::time_point begin = watch::now();
+
+    for (long tick = 0; tick < ticks; tick++) {
+        kind->step(tick);
+    }
+
+    double seconds = std::chrono::duration<double>(watch::now() - begin).count();
+
+    printf("{\"game\":\"%s\",\"lanes\":%ld,\"ticks\":%ld,\"checked\":%ld,\"seconds\":%.3f,\"steps\":%.0f}\n", kind->name,
+           lanes, ticks, count, seconds, lanes * ticks / seconds);
+
+    return 0;
+}
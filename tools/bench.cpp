@@ -0,0 +1,370 @@
+/**
+ * Benchmark games and device drivers in host, by game and level, on repeatable workloads
+ *
+ *     c++ -std=gnu++11 -fpermissive -O2 tools/bench.cpp -o bench
+ *     ./bench [TICKS] [rounds=ROUNDS] [script=FILE] [baseline=FILE] [tolerance=PERCENT] > current.json
+ *
+ * Each game is played TICKS ticks (20000 by default) in each level, from a fixed seed, by its automatic player, or
+ * by inputs of a script in the stream format of tools/equivalence.cpp (its level column is skipped, and the script
+ * is looped). Each game and level runs in a child process, so it starts from pristine state, and is played ROUNDS
+ * times (5 by default) keeping the fastest update time in host, as other values are the same in every round.
+ *
+ * A JSON line by game and level reports update (host nanoseconds and simulated microseconds on Uno by tick), screen
+ * render by time slot and display render by tick (pin toggles and simulated microseconds, see host.hpp), and bytes
+ * of game state in RAM. With a baseline (a previous output), each line also reports changes in percent, and exit
+ * status is 1 when a simulated or counted value grew beyond its printed rounding, or update time in host grew more
+ * than tolerance (10% by default), as it is noisy.
+ */
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include "host.hpp"
+
+#include "../games.hpp"
+
+const short levels = 4;
+const short metrics = 7;
+
+const char *names[metrics] = {"update", "simulated", "screen", "screening", "display", "displaying", "ram"};
+
+/**
+ * @brief Inputs of a tick, as in a stream
+ */
+struct input {
+    short first;
+    short second;
+    byte buttons;
+};
+
+/**
+ * @brief Values measured for a game in a level, in order of names
+ */
+struct result {
+    short game;
+    short level;
+    unsigned long ticks;
+    double values[metrics];
+};
+
+/**
+ * @brief Bytes of state of a game in RAM, as listed by each game
+ *
+ * @param id Game identifier
+ * @return Bytes
+ */
+unsigned footprint(byte id) {
+    switch (id) {
+#if GAMES_PONG
+        case 0:
+            return pong::footprint;
+#endif
+#if GAMES_SNAKE
+        case 1:
+            return snake::footprint;
+#endif
+#if GAMES_TETRIS
+        case 2:
+            return tetris::footprint;
+#endif
+#if GAMES_INVADERS
+        case 3:
+            return invaders::footprint;
+#endif
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Read a script, in the stream format of tools/equivalence.cpp
+ *
+ * @param path Path of script
+ * @return Inputs
+ */
+std::vector<input> load(const char *path) {
+    std::vector<input> inputs;
+
+    FILE *file = fopen(path, "r");
+
+    if (not file) {
+        perror(path);
+        exit(2);
+    }
+
+    char line[256];
+
+    while (fgets(line, sizeof(line), file)) {
+        int values[4];
+
+        if (line[0] == '#' or sscanf(line, "%d %d %d %d", &values[0], &values[1], &values[2], &values[3]) != 4) {
+            continue;
+        }
+
+        inputs.push_back({short(values[1]), short(values[2]), byte(values[3])});
+    }
+
+    fclose(file);
+
+    return inputs;
+}
+
+/**
+ * @brief Play a game in a level and measure it
+ *
+ * @param index Game position in table
+ * @param level Level
+ * @param ticks Ticks played
+ * @param script Inputs (automatic player when empty)
+ * @return Measured values
+ */
+result play(short index, short level, unsigned long ticks, const std::vector<input> &script) {
+    typedef std::chrono::steady_clock watch;
+
+    games::descriptor game = games::get(index);
+    result item{index, level, ticks, {}};
+
+    const short slots = things::shade.slots();
+
+    double *values = item.values;
+    bool restart = true;
+
+    randomSeed(1);
+
+    host::drive(things::inputDisplayPin, HIGH);  // Display lines are pulled up when released
+    host::drive(things::clockDisplayPin, HIGH);
+
+    for (unsigned long tick = 0; tick < ticks; tick++) {
+        host::clock = 1000ul * things::period * (tick + 1);
+
+        if (restart) {
+            game.start();
+        }
+
+        things::frame.clear();
+        things::shade.clear();
+
+        things::left.read();
+        things::right.read();
+        things::top.read();
+        things::bottom.read();
+
+        if (script.empty()) {
+            game.pilot();
+        } else {
+            const input &value = script[tick % script.size()];
+
+            if (value.buttons & 1) {
+                things::left.press();
+            }
+            if (value.buttons & 2) {
+                things::right.press();
+            }
+            if (value.buttons & 4) {
+                things::top.press();
+            }
+            if (value.buttons & 8) {
+                things::bottom.press();
+            }
+
+            things::first.drive(value.first, 0, 1023);
+            things::second.drive(value.second, 0, 1023);
+        }
+
+        unsigned long moment = host::clock;
+        watch::time_point begin = watch::now();
+
+        game.update(level);
+
+        values[0] += std::chrono::duration<double, std::nano>(watch::now() - begin).count();
+        values[1] += host::clock - moment;
+
+        for (short slice = 0; slice < slots; slice++) {
+            canvas::frame<things::width, things::height> image = things::frame;
+
+            image |= things::shade.slice(slice);
+
+            unsigned long flips = host::flips();
+
+            moment = host::clock;
+            things::screen.render(image);
+
+            values[2] += host::flips() - flips;
+            values[3] += host::clock - moment;
+        }
+
+        unsigned long flips = host::flips();
+
+        moment = host::clock;
+        things::display.render(things::layer);
+
+        values[4] += host::flips() - flips;
+        values[5] += host::clock - moment;
+
+        restart = game.verify();
+    }
+
+    for (short metric = 0; metric < 6; metric++) {
+        values[metric] /= metric == 2 or metric == 3 ? ticks * slots : ticks;
+    }
+
+    values[6] = footprint(game.id);
+
+    return item;
+}
+
+/**
+ * @brief Play in a child process, so each game and level starts from pristine state
+ *
+ * @param index Game position in table
+ * @param level Level
+ * @param ticks Ticks played
+ * @param script Inputs (automatic player when empty)
+ * @return Measured values
+ */
+result isolate(short index, short level, unsigned long ticks, const std::vector<input> &script) {
+    int ends[2];
+
+    if (pipe(ends) < 0) {
+        perror("pipe");
+        exit(2);
+    }
+
+    fflush(stdout);
+
+    pid_t child = fork();
+
+    if (child == 0) {
+        close(ends[0]);
+
+        result item = play(index, level, ticks, script);
+
+        _exit(write(ends[1], &item, sizeof(item)) == sizeof(item) ? 0 : 2);
+    }
+
+    close(ends[1]);
+
+    result item;
+
+    bool received = read(ends[0], &item, sizeof(item)) == sizeof(item);
+
+    close(ends[0]);
+    waitpid(child, nullptr, 0);
+
+    if (not received) {
+        fprintf(stderr, "game %d fails in level %d\n", index, level);
+        exit(2);
+    }
+
+    return item;
+}
+
+/**
+ * @brief Read a baseline, a previous output
+ *
+ * @param path Path of baseline
+ * @return Results
+ */
+std::vector<result> compare(const char *path) {
+    std::vector<result> items;
+
+    FILE *file = fopen(path, "r");
+
+    if (not file) {
+        perror(path);
+        exit(2);
+    }
+
+    char line[512];
+
+    while (fgets(line, sizeof(line), file)) {
+        result item;
+        double *values = item.values;
+
+        int game;
+        int level;
+
+        if (sscanf(line,
+                   "{\"game\":%d,\"level\":%d,\"ticks\":%lu,\"update\":[%lf,%lf],\"screen\":[%lf,%lf],"
+                   "\"display\":[%lf,%lf],\"ram\":%lf",
+                   &game, &level, &item.ticks, &values[0], &values[1], &values[2], &values[3], &values[4],
+                   &values[5], &values[6]) != 10) {
+            continue;
+        }
+
+        item.game = game;
+        item.level = level;
+
+        items.push_back(item);
+    }
+
+    fclose(file);
+
+    return items;
+}
+
+int main(int argc, char **argv) {
+    unsigned long ticks = 20000;
+    short rounds = 5;
+    double tolerance = 10;
+
+    std::vector<input> script;
+    std::vector<result> baseline;
+
+    for (int index = 1; index < argc; index++) {
+        if (strncmp(argv[index], "script=", 7) == 0) {
+            script = load(argv[index] + 7);
+        } else if (strncmp(argv[index], "baseline=", 9) == 0) {
+            baseline = compare(argv[index] + 9);
+        } else if (strncmp(argv[index], "rounds=", 7) == 0) {
+            rounds = max(atoi(argv[index] + 7), 1);
+        } else if (strncmp(argv[index], "tolerance=", 10) == 0) {
+            tolerance = atof(argv[index] + 10);
+        } else {
+            ticks = strtoul(argv[index], nullptr, 10);
+        }
+    }
+
+    bool regression = false;
+
+    for (short index = 0; index < games::count; index++) {
+        for (short level = 0; level < levels; level++) {
+            result item = isolate(index, level, ticks, script);
+
+            for (short round = 1; round < rounds; round++) {
+                item.values[0] = min(item.values[0], isolate(index, level, ticks, script).values[0]);
+            }
+
+            const double *values = item.values;
+
+            printf("{\"game\":%d,\"level\":%d,\"ticks\":%lu,\"update\":[%.1f,%.3f],\"screen\":[%.3f,%.3f],"
+                   "\"display\":[%.3f,%.3f],\"ram\":%.0f",
+                   index, level, ticks, values[0], values[1], values[2], values[3], values[4], values[5], values[6]);
+
+            for (const result &other : baseline) {
+                if (other.game != index or other.level != level) {
+                    continue;
+                }
+
+                printf(",\"change\":{");
+
+                for (short metric = 0; metric < metrics; metric++) {
+                    double before = other.values[metric];
+                    double change = before ? 100 * (values[metric] - before) / before : 0;
+
+                    printf("%s\"%s\":%.1f", metric ? "," : "", names[metric], change);
+
+                    regression = regression or (metric ? values[metric] > before + 0.001 : change > tolerance);
+                }
+
+                printf("}");
+            }
+
+            printf("}\n");
+        }
+    }
+
+    return regression ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * Join two boards playing linked pong (see lockstep.hpp) through host, relaying Serial bytes between two
+ * ports and printing link reports of both boards
+ *
+ *     c++ -std=c++11 -O2 tools/bridge.cpp -o bridge
+ *     ./bridge /dev/ttyACM0 /dev/ttyACM1
+ *
+ * Ports may be pseudo-terminals too (as made by socat), to stand in for a board or for the wire.
+ */
+#include <fcntl.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/**
+ * @brief Open a port in raw mode at 115200 baud
+ *
+ * @param path Port path
+ * @return File descriptor (-1 on failure)
+ */
+int open(const char *path) {
+    int port = ::open(path, O_RDWR | O_NOCTTY);
+
+    if (port < 0) {
+        return -1;
+    }
+
+    termios settings;
+
+    if (tcgetattr(port, &settings) == 0) {
+        cfmakeraw(&settings);
+        cfsetispeed(&settings, B115200);
+        cfsetospeed(&settings, B115200);
+
+        tcsetattr(port, TCSANOW, &settings);
+    }
+
+    return port;
+}
+
+/**
+ * @class monitor
+ * @brief Split link packets from text lines in bytes sent by a board
+ *
+ */
+class monitor {
+   private:
+    static const uint8_t sync = 0xB4;
+    static const unsigned size = 12;
+
+    const char *name;
+
+    unsigned skip{};
+    std::string line;
+
+   public:
+    /**
+     * @brief Initialize monitor
+     *
+     * @param name Board name, printed before its lines
+     */
+    monitor(const char *name) : name(name) {}
+
+    /**
+     * @brief Feed a byte, printing a text line when it ends
+     *
+     * @param data Byte
+     */
+    void feed(uint8_t data) {
+        if (skip) {
+            skip--;
+            return;
+        }
+        if (data == sync) {
+            skip = size - 1;
+            return;
+        }
+        if (data == '\r') {
+            return;
+        }
+        if (data != '\n') {
+            line += char(data);
+            return;
+        }
+
+        printf("%s %s\n", name, line.c_str());
+        fflush(stdout);
+
+        line.clear();
+    }
+};
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s first-port second-port\n", argv[0]);
+        return 1;
+    }
+
+    int ports[2] = {open(argv[1]), open(argv[2])};
+
+    if (ports[0] < 0 or ports[1] < 0) {
+        perror("open");
+        return 1;
+    }
+
+    monitor monitors[2] = {monitor("first"), monitor("second")};
+
+    while (true) {
+        fd_set ready;
+
+        FD_ZERO(&ready);
+        FD_SET(ports[0], &ready);
+        FD_SET(ports[1], &ready);
+
+        if (select((ports[0] > ports[1] ? ports[0] : ports[1]) + 1, &ready, nullptr, nullptr, nullptr) < 0) {
+            perror("select");
+            return 1;
+        }
+
+        for (int index = 0; index < 2; index++) {
+            if (not FD_ISSET(ports[index], &ready)) {
+                continue;
+            }
+
+            uint8_t buffer[256];
+
+            ssize_t length = read(ports[index], buffer, sizeof(buffer));
+
+            if (length <= 0) {
+                return 0;
+            }
+
+            if (write(ports[1 - index], buffer, length) != length) {
+                perror("write");
+                return 1;
+            }
+
+            for (ssize_t position = 0; position < length; position++) {
+                monitors[index].feed(buffer[position]);
+            }
+        }
+    }
+}
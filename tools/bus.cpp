@@ -0,0 +1,47 @@
+/**
+ * Decode logic analyzer captures of screen (MAX7219) and display (TM1637) pins back into register writes and
+ * commands, rebuilding state of devices, so bit level output of drivers can be checked and compared
+ *
+ *     c++ -std=c++11 -O2 tools/bus.cpp -o bus
+ *     ./bus screen DIN CLK LOAD [MODULES] < capture.csv
+ *     ./bus display DIO CLK < capture.csv
+ *
+ * Capture is CSV, one row by sample or by change (as exported by sigrok or Saleae), with an optional time column
+ * first when header names it. Pins are given as channel columns counted from zero, after time column.
+ * Lines starting with ';' or '#' are skipped.
+ */
+#include "bus.hpp"
+
+int main(int argc, char **argv) {
+    bool screening = argc >= 5 and strcmp(argv[1], "screen") == 0;
+    bool displaying = argc >= 4 and strcmp(argv[1], "display") == 0;
+
+    if (not screening and not displaying) {
+        fprintf(stderr, "usage: %s screen DIN CLK LOAD [MODULES] < capture.csv\n", argv[0]);
+        fprintf(stderr, "       %s display DIO CLK < capture.csv\n", argv[0]);
+        return 1;
+    }
+
+    unsigned pins[3] = {unsigned(atoi(argv[2])), unsigned(atoi(argv[3])), screening ? unsigned(atoi(argv[4])) : 0};
+
+    bus::screen chain(screening and argc >= 6 and atoi(argv[5]) > 0 ? atoi(argv[5]) : 1);
+    bus::display digits;
+
+    bus::capture samples;
+
+    while (samples.next()) {
+        if (screening) {
+            chain.feed(samples.time, samples.level(pins[0]), samples.level(pins[1]), samples.level(pins[2]));
+        } else {
+            digits.feed(samples.time, samples.level(pins[0]), samples.level(pins[1]));
+        }
+    }
+
+    if (screening) {
+        chain.print();
+    } else {
+        digits.print();
+    }
+
+    return 0;
+}
@@ -0,0 +1,373 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef BUS_HPP
+#define BUS_HPP
+
+namespace bus {
+/**
+ * @class capture
+ * @brief Read samples of channels from CSV
+ *
+ */
+class capture {
+   private:
+    FILE *file;
+
+    bool timed{false};
+    bool headed{false};
+
+    unsigned long index{};
+
+   public:
+    double time{};                // Seconds (sample index without time column)
+    std::vector<int> channels{};  // Levels
+
+    /**
+     * @brief Initialize capture
+     *
+     * @param file File to read, which may still grow while read
+     */
+    capture(FILE *file = stdin) : file(file) {}
+
+    /**
+     * @brief Read next sample
+     *
+     * @return If a sample was read
+     */
+    bool next() {
+        char line[1024];
+
+        clearerr(file);
+
+        while (fgets(line, sizeof(line), file)) {
+            if (line[0] == ';' or line[0] == '#' or line[0] == '\n' or line[0] == '\r') {
+                continue;
+            }
+
+            std::vector<std::string> fields;
+            std::string field;
+
+            for (char *position = line; *position and *position != '\n' and *position != '\r'; position++) {
+                if (*position == ',') {
+                    fields.push_back(field);
+                    field.clear();
+                } else if (*position != ' ' and *position != '"') {
+                    field += *position;
+                }
+            }
+
+            fields.push_back(field);
+
+            if (not headed) {
+                headed = true;
+
+                char *end;
+                strtod(fields[0].c_str(), &end);
+
+                if (*end != '\0' or fields[0].empty()) {
+                    timed = fields[0].find("ime") != std::string::npos;
+                    continue;
+                }
+            }
+
+            unsigned first = timed ? 1 : 0;
+
+            time = timed ? atof(fields[0].c_str()) : index;
+            index++;
+
+            channels.clear();
+
+            for (unsigned column = first; column < fields.size(); column++) {
+                channels.push_back(atoi(fields[column].c_str()) != 0);
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Level of a channel
+     *
+     * @param channel Channel
+     * @return Level
+     */
+    bool level(unsigned channel) const {  //
+        return channel < channels.size() and channels[channel];
+    }
+};
+
+/**
+ * @class screen
+ * @brief Rebuild a chain of MAX7219, bits are taken on clock rise and latched on load rise
+ *
+ */
+class screen {
+   private:
+    unsigned modules;
+
+    std::vector<bool> bits;
+
+    bool clock{true};
+    bool load{true};
+
+   public:
+    std::vector<uint8_t> rows;  // Digit registers, 8 by module
+    std::vector<uint8_t> controls;  // Registers 9 to 15, 7 by module
+
+    bool verbose{true};  // Print each register write
+
+    unsigned long latches{};
+    unsigned long writes{};
+    unsigned long noops{};
+    unsigned long shifted{};
+    unsigned long partial{};
+
+    /**
+     * @brief Initialize screen
+     *
+     * @param modules Modules in chain
+     */
+    screen(unsigned modules) : modules(modules), rows(8 * modules), controls(7 * modules) {}
+
+    /**
+     * @brief Feed a sample
+     *
+     * @param time Time of sample
+     * @param din Data level
+     * @param clk Clock level
+     * @param cs Load level
+     */
+    void feed(double time, bool din, bool clk, bool cs) {
+        if (clk and not clock) {
+            bits.push_back(din);
+            shifted++;
+        }
+
+        if (cs and not load) {
+            latch(time);
+        }
+
+        clock = clk;
+        load = cs;
+    }
+
+    /**
+     * @brief Latch shifted words in modules, last word shifted stays in first module
+     *
+     * @param time Time of latch
+     */
+    void latch(double time) {
+        latches++;
+
+        if (bits.size() % 16) {
+            partial++;
+        }
+
+        unsigned words = bits.size() / 16;
+
+        for (unsigned module = 0; module < modules and module < words; module++) {
+            unsigned offset = (words - 1 - module) * 16 + bits.size() % 16;
+            unsigned word = 0;
+
+            for (unsigned bit = 0; bit < 16; bit++) {
+                word = (word << 1) | bits[offset + bit];
+            }
+
+            unsigned address = (word >> 8) & 0xF;
+            unsigned data = word & 0xFF;
+
+            if (address == 0) {
+                noops++;
+                continue;
+            }
+
+            writes++;
+
+            if (address <= 8) {
+                rows[8 * module + address - 1] = data;
+            } else {
+                controls[7 * module + address - 9] = data;
+            }
+
+            if (verbose) {
+                printf("%.6f screen module %u register %X = %02X\n", time, module, address, data);
+            }
+        }
+
+        bits.clear();
+    }
+
+    /**
+     * @brief Columns of chain, 8 by module
+     *
+     * @return Columns
+     */
+    unsigned width() const {  //
+        return 8 * modules;
+    }
+
+    /**
+     * @brief Pixel of chain, first module on the left and its first column in least significant bit of a row
+     *
+     * @param line Line
+     * @param column Column from the left of first module
+     * @return Lit
+     */
+    bool lit(unsigned line, unsigned column) const {  //
+        return (rows[8 * (column / 8) + line] >> (column % 8)) & 1;
+    }
+
+    /**
+     * @brief Print modules state
+     */
+    void print() const {
+        printf("screen intensity %u, scan limit %u, shutdown %u, test %u, decode %u\n", controls[1], controls[2],
+               controls[3], controls[6], controls[0]);
+
+        for (unsigned line = 0; line < 8; line++) {
+            for (unsigned column = 0; column < width(); column++) {
+                putchar(lit(line, column) ? '#' : '.');
+            }
+
+            putchar('\n');
+        }
+
+        printf("screen %lu latches, %lu writes, %lu no-ops, %lu bits, %lu partial\n", latches, writes, noops, shifted,
+               partial);
+    }
+};
+
+/**
+ * @class display
+ * @brief Rebuild a TM1637, frames go from start (data falls with clock high) to stop (data rises with clock high),
+ * bytes are least significant bit first with an acknowledge clock after each one
+ *
+ */
+class display {
+   private:
+    bool clock{true};
+    bool data{true};
+
+    bool framed{false};
+
+    unsigned bit{};
+    unsigned value{};
+
+    std::vector<uint8_t> bytes;
+
+   public:
+    uint8_t digits[6]{};
+    unsigned bright{};
+    bool on{false};
+
+    bool verbose{true};  // Print each frame
+
+    unsigned long frames{};
+    unsigned long written{};
+    unsigned long nacks{};
+
+    /**
+     * @brief Feed a sample
+     *
+     * @param time Time of sample
+     * @param dio Data level
+     * @param clk Clock level
+     */
+    void feed(double time, bool dio, bool clk) {
+        if (clk and clock and dio != data) {
+            if (not dio) {
+                framed = true;
+                bit = 0;
+                value = 0;
+                bytes.clear();
+            } else if (framed) {
+                framed = false;
+                apply(time);
+            }
+        } else if (framed and clk and not clock) {
+            if (bit < 8) {
+                value |= dio << bit;
+            } else if (dio) {
+                nacks++;
+            }
+
+            if (++bit == 9) {
+                bytes.push_back(value);
+                bit = 0;
+                value = 0;
+            }
+        }
+
+        clock = clk;
+        data = dio;
+    }
+
+    /**
+     * @brief Apply a complete frame
+     *
+     * @param time Time of frame end
+     */
+    void apply(double time) {
+        if (bytes.empty()) {
+            return;
+        }
+
+        frames++;
+        written += bytes.size();
+
+        uint8_t command = bytes[0];
+
+        if (verbose) {
+            printf("%.6f display", time);
+
+            for (uint8_t byte : bytes) {
+                printf(" %02X", byte);
+            }
+
+            printf("\n");
+        }
+
+        if ((command & 0xC0) == 0xC0) {
+            for (unsigned index = 1; index < bytes.size(); index++) {
+                digits[((command & 0x7) + index - 1) % 6] = bytes[index];
+            }
+        } else if ((command & 0xC0) == 0x80) {
+            on = command & 0x8;
+            bright = command & 0x7;
+        }
+    }
+
+    /**
+     * @brief Print display state, digits decoded from segments ('?' when unknown) and separator bit as ':'
+     */
+    void print() const {
+        static const uint8_t codes[] = {63, 6, 91, 79, 102, 109, 125, 7, 127, 111, 64, 0};
+        static const char names[] = "0123456789- ";
+
+        printf("display %s, brightness %u, digits ", on ? "on" : "off", bright);
+
+        for (unsigned index = 0; index < 4; index++) {
+            char name = '?';
+
+            for (unsigned code = 0; code < sizeof(codes); code++) {
+                if ((digits[index] & 0x7F) == codes[code]) {
+                    name = names[code];
+                }
+            }
+
+            printf("%c%s", name, digits[index] & 0x80 ? ":" : "");
+        }
+
+        printf("\ndisplay %lu frames, %lu bytes, %lu not acknowledged\n", frames, written, nacks);
+    }
+};
+}  // namespace bus
+
+#endif
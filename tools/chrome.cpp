@@ -0,0 +1,123 @@
+/**
+ * Convert trace dumps from Serial (see trace.hpp) to Chrome trace JSON,
+ * to be opened in chrome://tracing or Perfetto
+ *
+ *     c++ -std=c++11 -O2 tools/chrome.cpp -o chrome
+ *     ./chrome < capture.bin > trace.json
+ *
+ * Names of tasks and game events come from the capture, so it should start at boot (opening Serial resets Uno).
+ */
+#include <cstdint>
+#include <cstdio>
+
+char names[256][256];  // Names sent by sketch, by identifier
+
+/**
+ * @brief Name of an event identifier, as sent by sketch, or made up when it was not
+ *
+ * @param id Identifier
+ * @return Name
+ */
+const char *name(unsigned id) {
+    if (not names[id][0]) {
+        snprintf(names[id], sizeof(names[id]), id < 32 ? "task %u" : "event %u", id);
+    }
+
+    return names[id];
+}
+
+/**
+ * @brief Read a byte
+ *
+ * @param data Byte read
+ * @return If a byte was read
+ */
+bool next(unsigned &data) {
+    int value = getchar();
+
+    data = value;
+
+    return value != EOF;
+}
+
+int main() {
+    unsigned long long clock = 0;  // Unwrapped time in units of 4 microseconds
+    unsigned last = 0;
+    bool first = true;
+
+    unsigned data;
+    unsigned previous = 0;
+
+    unsigned long dumps = 0;
+    unsigned long lost = 0;
+
+    printf("{\"traceEvents\":[\n");
+
+    while (next(data)) {
+        if (previous != 0x5A or (data != 'T' and data != 'N')) {
+            previous = data;
+            continue;
+        }
+
+        previous = 0;
+
+        if (data == 'N') {
+            unsigned id, length;
+
+            if (not next(id) or not next(length)) {
+                break;
+            }
+
+            for (unsigned index = 0; index < length; index++) {
+                unsigned character;
+
+                if (not next(character)) {
+                    break;
+                }
+
+                names[id][index] = character;
+            }
+
+            names[id][length] = 0;
+
+            continue;
+        }
+
+        unsigned count, dropped;
+
+        if (not next(count) or not next(dropped)) {
+            break;
+        }
+
+        dumps++;
+        lost += dropped;
+
+        for (unsigned index = 0; index < count; index++) {
+            unsigned bytes[4];
+
+            if (not(next(bytes[0]) and next(bytes[1]) and next(bytes[2]) and next(bytes[3]))) {
+                break;
+            }
+
+            unsigned time = bytes[0] | (bytes[1] << 8);
+
+            if (first) {
+                last = time;
+            }
+
+            clock += (time - last) & 0xFFFF;
+            last = time;
+
+            printf("%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":0,\"tid\":0%s}", first ? "" : ",\n",
+                   name(bytes[2]), bytes[3], clock * 4, bytes[3] == 'i' ? ",\"s\":\"t\"" : "");
+
+            first = false;
+        }
+    }
+
+    printf("\n]}\n");
+
+    fprintf(stderr, "%lu dumps, %lu events lost\n", dumps, lost);
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * Estimate frame time on Uno, running the whole sketch in host with the cost of each Arduino call on device charged
+ * to a simulated clock (see host.hpp). Games are played by attract mode, so all of them are covered in turn
+ *
+ *     c++ -std=gnu++11 -fpermissive -O2 -Itools tools/cost.cpp -o cost
+ *     ./cost [SECONDS] [level=LEVEL] [verbose] [serial=FILE] [NAME=NANOSECONDS...]
+ *
+ * Each engine::run call runs at most one task, and its cost is the simulated time it took. A JSON line by game and
+ * level reports tasks (runs, average and peak microseconds), then busy time in each period of things::period (average
+ * and peak) and how many periods went over budget. With verbose, each run is printed as time, task and microseconds.
+ * Call costs can be changed, as write=125 to model direct port writes (see host::costs). Serial output of the sketch,
+ * as reports of profile and monitor switches (see things.hpp), is written to FILE, with - for standard error.
+ */
+#include "host.hpp"
+
+#include "../engine.hpp"
+
+const short tasks = sizeof(engine::tasks) / sizeof(*engine::tasks);
+const short levels = 4;
+
+/**
+ * @brief Costs measured for a game in a level
+ */
+struct tally {
+    unsigned long runs[tasks];
+    unsigned long spent[tasks];
+    unsigned long peaks[tasks];
+
+    unsigned long periods;
+    unsigned long busy;
+    unsigned long peak;
+    unsigned long overruns;
+};
+
+tally tallies[games::count][levels]{};
+
+/**
+ * @brief Print tallies as JSON lines
+ */
+void report() {
+    for (short game = 0; game < games::count; game++) {
+        for (short level = 0; level < levels; level++) {
+            tally &item = tallies[game][level];
+
+            if (not item.periods) {
+                continue;
+            }
+
+            printf("{\"game\":%d,\"level\":%d,\"tasks\":[", game, level);
+
+            for (short index = 0; index < tasks; index++) {
+                unsigned long runs = item.runs[index];
+
+                printf("%s[%lu,%lu,%lu]", index ? "," : "", runs, runs ? item.spent[index] / runs : 0,
+                       item.peaks[index]);
+            }
+
+            printf("],\"periods\":%lu,\"busy\":%lu,\"peak\":%lu,\"overruns\":%lu}\n", item.periods,
+                   item.busy / item.periods, item.peak, item.overruns);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    unsigned long seconds = 600;
+    short level = 0;
+    bool verbose = false;
+
+    for (int index = 1; index < argc; index++) {
+        if (strncmp(argv[index], "level=", 6) == 0) {
+            level = atoi(argv[index] + 6) % levels;
+        } else if (strcmp(argv[index], "verbose") == 0) {
+            verbose = true;
+        } else if (strncmp(argv[index], "serial=", 7) == 0) {
+            const char *path = argv[index] + 7;
+
+            host::output = strcmp(path, "-") == 0 ? stderr : fopen(path, "wb");
+
+            if (not host::output) {
+                perror(path);
+                return 1;
+            }
+        } else if (strchr(argv[index], '=')) {
+            if (not host::configure(argv[index])) {
+                fprintf(stderr, "unknown cost %s\n", argv[index]);
+                return 1;
+            }
+        } else {
+            seconds = strtoul(argv[index], nullptr, 10);
+        }
+    }
+
+    host::analogs[things::levelPin] = map(level, 0, 3, 0, 1023);
+    host::analogs[things::brightPin] = 512;
+
+    engine::init();
+
+    const unsigned long budget = 1000ul * things::period;
+
+    unsigned long period = host::clock / budget;
+    unsigned long busy = 0;
+
+    while (host::clock < 1000000ul * seconds) {
+        unsigned long moment = host::clock;
+
+        short index = scheduler::dispatch(engine::tasks);
+
+        if (index < 0) {
+            monitor::idle();
+            continue;
+        }
+
+        unsigned long spent = host::clock - moment;
+
+        if (verbose) {
+            printf("%lu %d %lu\n", moment, index, spent);
+        }
+
+        if (not engine::playing) {
+            continue;
+        }
+
+        tally &item = tallies[engine::choice][engine::level];
+
+        item.runs[index]++;
+        item.spent[index] += spent;
+        item.peaks[index] = max(item.peaks[index], spent);
+
+        if (moment / budget != period) {
+            item.periods++;
+            item.busy += busy;
+            item.peak = max(item.peak, busy);
+            item.overruns += busy > budget;
+
+            period = moment / budget;
+            busy = 0;
+        }
+
+        busy += spent;
+    }
+
+    report();
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * Decode a telemetry capture from Serial into text frames
+ *
+ *     c++ -std=c++11 -O2 tools/decode.cpp -o decode
+ *     ./decode < capture.bin
+ */
+#include <cstdio>
+
+#include "session.hpp"
+
+/**
+ * @brief Print a frame as text
+ *
+ * @param frame Frame state
+ */
+void print(const session::state &frame) {
+    unsigned width = frame.width;
+
+    printf("# %u ms, sequence %u, frames %u, digits", frame.time, frame.sequence, frame.frames);
+
+    for (int digit : frame.digits) {
+        if (digit < 0) {
+            printf(" _");
+        } else if (digit == 10) {
+            printf(" -");
+        } else {
+            printf(" %d", digit);
+        }
+    }
+
+    printf("\n");
+
+    for (uint32_t row : frame.rows) {
+        for (unsigned column = 0; column < width; column++) {
+            putchar((row >> (width - 1 - column)) & 1 ? '#' : '.');
+        }
+
+        putchar('\n');
+    }
+}
+
+int main() {
+    session::decoder decoder;
+
+    int data;
+
+    while ((data = getchar()) != EOF) {
+        if (decoder.feed(data)) {
+            print(decoder.get());
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,788 @@
+/**
+ * Check rewrites of game logic against frozen copies of it (see reference.hpp), running both in lockstep on same
+ * inputs and comparing state and rendered frame each tick. At first divergence inputs are minimized, and printed as
+ * a stream that replays it
+ *
+ *     c++ -std=gnu++11 -fpermissive -O2 tools/equivalence.cpp -o equivalence
+ *     ./equivalence orthos
+ *     ./equivalence tetris|snake [STREAMS [TICKS]]
+ *     ./equivalence tetris|snake replay < stream.txt
+ *
+ * A stream holds a tick by line: level, first and second knobs (raw, 0 to 1023) and pressed buttons (left, right,
+ * top and bottom in bits 0 to 3). Lines starting with '#' are skipped. Game headers run with Arduino core stand-ins
+ * (see host.hpp) and need -fpermissive, as Arduino builds sketches with it.
+ *
+ * Each seed from 1 to STREAMS gives a random stream, and a stream recorded from automatic player of current
+ * implementation with bursts of random inputs.
+ */
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <vector>
+
+#include "host.hpp"
+
+#include "../snake.hpp"
+#include "../tetris.hpp"
+#include "reference.hpp"
+
+/**
+ * @brief Inputs of a tick
+ */
+struct input {
+    short level;
+    short first;
+    short second;
+    byte buttons;
+};
+
+typedef std::vector<input> stream;
+
+/**
+ * @brief Entry points of an implementation, hash is taken on state as the game sees it
+ */
+struct game {
+    void (*start)();
+    void (*update)(int);
+    bool (*verify)();
+    unsigned short (*result)();
+    uint32_t (*hash)();
+};
+
+/**
+ * @brief Frozen and current implementations of a game
+ */
+struct contest {
+    const char *name;
+    game frozen;
+    game current;
+    void (*pilot)();  // Automatic player of current implementation, to record streams
+};
+
+/**
+ * @brief What a tick leaves behind
+ */
+struct outcome {
+    uint32_t hash;
+    bool defeat;
+    unsigned short result;
+
+    canvas::frame<things::width, things::height> frame;
+    canvas::planes<2, things::width, things::height> shade;
+    canvas::layer layer;
+};
+
+/**
+ * @class digest
+ * @brief FNV-1a hash of values
+ *
+ */
+class digest {
+   private:
+    uint32_t value{2166136261u};
+
+   public:
+    /**
+     * @brief Add a value
+     *
+     * @param number Value
+     */
+    void add(long number) {
+        for (short index = 0; index < 4; index++) {
+            value = (value ^ byte(number >> (8 * index))) * 16777619u;
+        }
+    }
+
+    /**
+     * @brief Add a point
+     *
+     * @param point Point
+     */
+    void add(const geometry::point &point) {
+        add(point.get(true));
+        add(point.get(false));
+    }
+
+    /**
+     * @brief Hash of values added
+     *
+     * @return Hash
+     */
+    uint32_t get() const {  //
+        return value;
+    }
+};
+
+namespace frozen {
+/**
+ * @brief Hash of frozen tetris
+ *
+ * @return Hash
+ */
+uint32_t tetris() {
+    using namespace reference::tetris;
+
+    digest state;
+
+    for (auto row : frame) {
+        state.add(row);
+    }
+    for (auto &part : block) {
+        state.add(part);
+    }
+
+    long values[] = {position, rotation, level, steps, count, piece, score.get(), change, press, rotate[0], rotate[1]};
+
+    for (long value : values) {
+        state.add(value);
+    }
+
+    return state.get();
+}
+
+/**
+ * @brief Hash of frozen snake, body is taken from head to tail
+ *
+ * @return Hash
+ */
+uint32_t snake() {
+    using namespace reference::snake;
+
+    digest state;
+
+    for (short index = 0; index < length; index++) {
+        state.add(body[index]);
+    }
+    for (short index = 0; index < pending; index++) {
+        state.add(turns[index]);
+    }
+
+    state.add(food);
+    state.add(sense);
+
+    long values[] = {length, pending, left, right, top, bottom, level, steps, count, points.get()};
+
+    for (long value : values) {
+        state.add(value);
+    }
+
+    return state.get();
+}
+}  // namespace frozen
+
+namespace current {
+/**
+ * @brief Hash of current tetris
+ *
+ * @return Hash
+ */
+uint32_t tetris() {
+    using namespace ::tetris;
+
+    digest state;
+
+    for (auto row : frame) {
+        state.add(row);
+    }
+    for (auto &part : block) {
+        state.add(part);
+    }
+
+    long values[] = {position, rotation, level, steps, count, piece, score.get(), change, press, rotate[0], rotate[1]};
+
+    for (long value : values) {
+        state.add(value);
+    }
+
+    return state.get();
+}
+
+/**
+ * @brief Hash of current snake, body is taken from head to tail
+ *
+ * @return Hash
+ */
+uint32_t snake() {
+    using namespace ::snake;
+
+    digest state;
+
+    for (short index = 0; index < length; index++) {
+        state.add(body[index]);
+    }
+    for (short index = 0; index < pending; index++) {
+        state.add(turns[index]);
+    }
+
+    state.add(food);
+    state.add(sense);
+
+    long values[] = {length, pending, left, right, top, bottom, level, steps, count, points.get()};
+
+    for (long value : values) {
+        state.add(value);
+    }
+
+    return state.get();
+}
+}  // namespace current
+
+const contest contests[] = {
+    {"tetris",
+     {reference::tetris::start, reference::tetris::update, reference::tetris::verify, reference::tetris::result,
+      frozen::tetris},
+     {tetris::start, tetris::update, tetris::verify, tetris::result, current::tetris},
+     tetris::pilot},
+    {"snake",
+     {reference::snake::start, reference::snake::update, reference::snake::verify, reference::snake::result,
+      frozen::snake},
+     {snake::start, snake::update, snake::verify, snake::result, current::snake},
+     snake::pilot},
+};
+
+/**
+ * @brief Run a tick of an implementation, as engine does
+ *
+ * @param kind Implementation
+ * @param value Inputs (set by automatic player, when given)
+ * @param tick Tick
+ * @param restart If a round starts before tick
+ * @param pilot Automatic player
+ * @return Outcome
+ */
+outcome step(const game &kind, input &value, long tick, bool restart, void (*pilot)() = nullptr) {
+    host::clock = 1000ul * things::period * (tick + 1);
+
+    if (restart) {
+        kind.start();
+    }
+
+    things::frame.clear();
+    things::shade.clear();
+    things::layer.clear();
+
+    things::left.read();
+    things::right.read();
+    things::top.read();
+    things::bottom.read();
+
+    if (pilot) {
+        pilot();
+
+        value.first = things::first.read(0, 1023);
+        value.second = things::second.read(0, 1023);
+
+        value.buttons = things::left.read() | things::right.read() << 1 | things::top.read() << 2;
+        value.buttons |= things::bottom.read() << 3;
+    }
+
+    if (value.buttons & 1) {
+        things::left.press();
+    }
+    if (value.buttons & 2) {
+        things::right.press();
+    }
+    if (value.buttons & 4) {
+        things::top.press();
+    }
+    if (value.buttons & 8) {
+        things::bottom.press();
+    }
+
+    things::first.drive(value.first, 0, 1023);
+    things::second.drive(value.second, 0, 1023);
+
+    kind.update(map(value.level, 0, 1023, 0, 3));
+
+    outcome result;
+
+    result.frame = things::frame;
+    result.shade = things::shade;
+    result.layer = things::layer;
+
+    result.defeat = kind.verify();
+    result.result = kind.result();
+
+    digest state;
+
+    state.add(kind.hash());
+    state.add(host::state);
+
+    result.hash = state.get();
+
+    return result;
+}
+
+/**
+ * @brief Compare outcomes of a tick
+ *
+ * @param one Outcome of frozen implementation
+ * @param other Outcome of current implementation
+ * @return What differs (null when nothing)
+ */
+const char *compare(const outcome &one, const outcome &other) {
+    if (one.hash != other.hash) {
+        return "state";
+    }
+    if (one.defeat != other.defeat) {
+        return "defeat";
+    }
+    if (one.result != other.result) {
+        return "score";
+    }
+    if (not(one.frame == other.frame)) {
+        return "frame";
+    }
+
+    for (short slot = 0; slot < things::shade.slots(); slot++) {
+        if (not(one.shade.slice(slot) == other.shade.slice(slot))) {
+            return "shade";
+        }
+    }
+    for (short index = 0; index < 4; index++) {
+        if (one.layer.get(index) != other.layer.get(index)) {
+            return "digits";
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Print rendered outcomes side by side ('#' lit, '+' shaded)
+ *
+ * @param one Outcome of frozen implementation
+ * @param other Outcome of current implementation
+ */
+void print(const outcome &one, const outcome &other) {
+    printf("# reference: hash %08X, defeat %d, score %X\n", one.hash, one.defeat, one.result);
+    printf("# current:   hash %08X, defeat %d, score %X\n", other.hash, other.defeat, other.result);
+
+    for (short line = 0; line < things::height; line++) {
+        printf("# ");
+
+        for (const outcome *side : {&one, &other}) {
+            for (short column = 0; column < things::width; column++) {
+                bool shaded = false;
+
+                for (short slot = 0; slot < things::shade.slots(); slot++) {
+                    shaded = shaded or side->shade.slice(slot).get(line, column);
+                }
+
+                putchar(side->frame.get(line, column) ? '#' : shaded ? '+' : '.');
+            }
+
+            printf("   ");
+        }
+
+        putchar('\n');
+    }
+
+    printf("# digits");
+
+    for (const outcome *side : {&one, &other}) {
+        for (short index = 0; index < 4; index++) {
+            printf(" %d", side->layer.get(index));
+        }
+
+        printf("   ");
+    }
+
+    putchar('\n');
+}
+
+/**
+ * @brief Run both implementations of a game in lockstep, rounds start again on defeat
+ *
+ * @param game Game
+ * @param inputs Inputs
+ * @param verbose If divergence is printed
+ * @return Tick of first divergence (-1 when none)
+ */
+long run(const contest &game, const stream &inputs, bool verbose) {
+    bool restart = true;
+
+    randomSeed(1);
+
+    for (long tick = 0; tick < long(inputs.size()); tick++) {
+        input value = inputs[tick];
+
+        unsigned long seed = host::state;
+
+        outcome one = step(game.frozen, value, tick, restart);
+
+        unsigned long reached = host::state;
+
+        host::state = seed;
+
+        outcome other = step(game.current, value, tick, restart);
+
+        const char *difference = compare(one, other);
+
+        if (difference) {
+            if (verbose) {
+                printf("# %s diverges in %s at tick %ld\n", game.name, difference, tick);
+                print(one, other);
+            }
+
+            return tick;
+        }
+
+        host::state = reached;
+        restart = one.defeat;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Run in a child process, so each run starts from pristine game state and a crash or a hang is caught
+ *
+ * @param game Game
+ * @param inputs Inputs
+ * @param verbose If divergence is printed
+ * @return Tick of first divergence (-1 when none, last tick when child fails)
+ */
+long isolate(const contest &game, const stream &inputs, bool verbose) {
+    int ends[2];
+
+    if (pipe(ends) < 0) {
+        perror("pipe");
+        exit(2);
+    }
+
+    fflush(stdout);
+
+    pid_t child = fork();
+
+    if (child == 0) {
+        close(ends[0]);
+        alarm(10);
+
+        long tick = run(game, inputs, verbose);
+
+        fflush(stdout);
+
+        if (write(ends[1], &tick, sizeof(tick)) != sizeof(tick)) {
+            _exit(2);
+        }
+
+        _exit(0);
+    }
+
+    close(ends[1]);
+
+    long tick;
+    int status;
+
+    bool received = read(ends[0], &tick, sizeof(tick)) == sizeof(tick);
+
+    close(ends[0]);
+    waitpid(child, &status, 0);
+
+    if (received) {
+        return tick;
+    }
+
+    if (verbose) {
+        printf("# %s fails (status %d) before tick %zu\n", game.name, status, inputs.size());
+    }
+
+    return long(inputs.size()) - 1;
+}
+
+/**
+ * @brief Minimize a diverging stream, removing chunks of ticks and then simplifying inputs while it diverges
+ *
+ * @param game Game
+ * @param inputs Diverging inputs
+ * @return Minimized inputs
+ */
+stream minimize(const contest &game, stream inputs) {
+    inputs.resize(isolate(game, inputs, false) + 1);
+
+    for (size_t chunk = inputs.size() / 2; chunk > 0; chunk /= 2) {
+        for (size_t start = 0; start < inputs.size() and inputs.size() > 1;) {
+            stream candidate(inputs);
+
+            candidate.erase(candidate.begin() + start, candidate.begin() + min(start + chunk, candidate.size()));
+
+            long tick = candidate.empty() ? -1 : isolate(game, candidate, false);
+
+            if (tick < 0) {
+                start += chunk;
+                continue;
+            }
+
+            candidate.resize(tick + 1);
+            inputs = candidate;
+        }
+    }
+
+    for (size_t tick = 0; tick < inputs.size(); tick++) {
+        input previous = tick ? inputs[tick - 1] : input{0, 0, 0, 0};
+
+        input simpler[] = {
+            {inputs[tick].level, inputs[tick].first, inputs[tick].second, 0},
+            {previous.level, inputs[tick].first, inputs[tick].second, inputs[tick].buttons},
+            {inputs[tick].level, previous.first, inputs[tick].second, inputs[tick].buttons},
+            {inputs[tick].level, inputs[tick].first, previous.second, inputs[tick].buttons},
+        };
+
+        for (input &value : simpler) {
+            value.buttons = min(value.buttons, inputs[tick].buttons);
+
+            stream candidate(inputs);
+
+            candidate[tick] = value;
+
+            long last = isolate(game, candidate, false);
+
+            if (last >= 0 and size_t(last) >= tick) {
+                candidate.resize(last + 1);
+                inputs = candidate;
+            }
+        }
+    }
+
+    return inputs;
+}
+
+/**
+ * @brief Generate a random stream, knobs wander and buttons are pressed now and then
+ *
+ * @param seed Seed
+ * @param ticks Length
+ * @return Inputs
+ */
+stream generate(unsigned long seed, long ticks) {
+    unsigned long state = seed;
+
+    auto next = [&state](long maximum) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return long((state >> 33) % maximum);
+    };
+
+    stream inputs;
+    input value{short(next(1024)), short(next(1024)), short(next(1024)), 0};
+
+    for (long tick = 0; tick < ticks; tick++) {
+        if (next(500) == 0) {
+            value.level = next(1024);
+        }
+
+        for (short *knob : {&value.first, &value.second}) {
+            if (next(64) == 0) {
+                *knob = next(1024);
+            } else if (next(8) == 0) {
+                *knob = max(0, min(1023, *knob + next(301) - 150));
+            }
+        }
+
+        value.buttons = next(16) == 0 ? 1 << next(4) : 0;
+
+        inputs.push_back(value);
+    }
+
+    return inputs;
+}
+
+/**
+ * @brief Record a stream played by automatic player of current implementation, in a child process as game state
+ * is left behind, with random inputs now and then so rounds differ
+ *
+ * @param game Game
+ * @param seed Seed of random inputs
+ * @param ticks Length
+ * @return Inputs
+ */
+stream record(const contest &game, unsigned long seed, long ticks) {
+    int ends[2];
+
+    if (pipe(ends) < 0) {
+        perror("pipe");
+        exit(2);
+    }
+
+    fflush(stdout);
+
+    pid_t child = fork();
+
+    if (child == 0) {
+        close(ends[0]);
+
+        stream noise = generate(seed, ticks);
+        bool restart = true;
+
+        randomSeed(1);
+
+        for (long tick = 0; tick < ticks; tick++) {
+            input value = noise[tick];
+
+            bool noisy = tick % 256 < 16;
+
+            restart = step(game.current, value, tick, restart, noisy ? nullptr : game.pilot).defeat;
+
+            if (write(ends[1], &value, sizeof(value)) != sizeof(value)) {
+                _exit(2);
+            }
+        }
+
+        _exit(0);
+    }
+
+    close(ends[1]);
+
+    stream inputs;
+    input value;
+
+    while (read(ends[0], &value, sizeof(value)) == sizeof(value)) {
+        inputs.push_back(value);
+    }
+
+    close(ends[0]);
+    waitpid(child, nullptr, 0);
+
+    return inputs;
+}
+
+/**
+ * @brief Print a stream, so it replays
+ *
+ * @param inputs Inputs
+ */
+void print(const stream &inputs) {
+    for (const input &value : inputs) {
+        printf("%d %d %d %d\n", value.level, value.first, value.second, value.buttons);
+    }
+}
+
+/**
+ * @brief Read a stream
+ *
+ * @return Inputs
+ */
+stream load() {
+    stream inputs;
+    char line[256];
+
+    while (fgets(line, sizeof(line), stdin)) {
+        int values[4];
+
+        if (line[0] == '#' or sscanf(line, "%d %d %d %d", &values[0], &values[1], &values[2], &values[3]) != 4) {
+            continue;
+        }
+
+        inputs.push_back({short(values[0]), short(values[1]), short(values[2]), byte(values[3])});
+    }
+
+    return inputs;
+}
+
+/**
+ * @brief Compare orthogonal rotations in all points and centers of a square around origin, and all angles
+ *
+ * @return If both agree
+ */
+bool orthos() {
+    const short reach = 16;
+
+    for (short angle = -8; angle <= 8; angle++) {
+        for (short vertical = -reach; vertical < reach; vertical++) {
+            for (short horizontal = -reach; horizontal < reach; horizontal++) {
+                geometry::point center(vertical, horizontal);
+
+                for (short line = -reach; line < reach; line++) {
+                    for (short column = -reach; column < reach; column += 4) {
+                        geometry::object<4> shape({geometry::point(line, column), geometry::point(line, column + 1),
+                                                   geometry::point(line, column + 2), geometry::point(line, column + 3)});
+
+                        geometry::object<4> one = reference::orthos(shape, center, angle);
+                        geometry::object<4> other = geometry::orthos(shape, center, angle);
+
+                        for (short index = 0; index < 4; index++) {
+                            geometry::point single = geometry::orthos(shape[index], center, angle);
+
+                            if (one[index] == other[index] and one[index] == single) {
+                                continue;
+                            }
+
+                            printf("# orthos diverges: point %d %d, center %d %d, angle %d\n", shape[index].get(true),
+                                   shape[index].get(false), vertical, horizontal, angle);
+                            printf("# reference %d %d, current %d %d (object %d %d)\n", one[index].get(true),
+                                   one[index].get(false), single.get(true), single.get(false), other[index].get(true),
+                                   other[index].get(false));
+
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    printf("# orthos agrees\n");
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    host::freeze();
+
+    if (argc >= 2 and strcmp(argv[1], "orthos") == 0) {
+        return orthos() ? 0 : 1;
+    }
+
+    const contest *game = nullptr;
+
+    for (const contest &other : contests) {
+        if (argc >= 2 and strcmp(argv[1], other.name) == 0) {
+            game = &other;
+        }
+    }
+
+    if (not game) {
+        fprintf(stderr, "usage: %s orthos\n", argv[0]);
+        fprintf(stderr, "       %s tetris|snake [STREAMS [TICKS]]\n", argv[0]);
+        fprintf(stderr, "       %s tetris|snake replay < stream.txt\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<stream> streams;
+
+    bool replay = argc >= 3 and strcmp(argv[2], "replay") == 0;
+
+    if (replay) {
+        streams.push_back(load());
+    } else {
+        long count = argc >= 3 ? atol(argv[2]) : 100;
+        long ticks = argc >= 4 ? atol(argv[3]) : 2000;
+
+        for (long seed = 1; seed <= count; seed++) {
+            streams.push_back(generate(seed, ticks));
+            streams.push_back(record(*game, seed, ticks));
+        }
+    }
+
+    for (size_t index = 0; index < streams.size(); index++) {
+        if (isolate(*game, streams[index], false) < 0) {
+            continue;
+        }
+
+        const char *kind = replay ? "replayed" : index % 2 ? "recorded" : "random";
+
+        fprintf(stderr, "%s stream %zu diverges, minimizing\n", kind, replay ? 1 : index / 2 + 1);
+
+        stream inputs = minimize(*game, streams[index]);
+
+        isolate(*game, inputs, true);
+        print(inputs);
+
+        return 1;
+    }
+
+    printf("# %s agrees in %zu streams\n", game->name, streams.size());
+
+    return 0;
+}
@@ -0,0 +1,515 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+#include <poll.h>
+#include <unistd.h>
+
+#ifndef HOST_HPP
+#define HOST_HPP
+
+/**
+ * Arduino core stand-ins, so game headers and the whole sketch build and run in host. Time is simulated: each call
+ * charges its cost on Uno (see host::costs) to host::clock, so a run is reproducible, can be rewound, and estimates
+ * time spent on device. Pins keep their mode and level, count toggles and can be logged as CSV (see tools/bus.cpp).
+ * Serial can be backed by a socket or a port (see host::port), so linked boards run in host (see tools/link.cpp).
+ * Stack below the sketch is painted and scanned as free RAM on Uno (see monitor.hpp), in bytes of host stack.
+ *
+ * Tools using storage also need avr/eeprom.h stand-in, by building with -Itools.
+ */
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PI 3.1415926535897932384626433832795
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define MSBFIRST 1
+#define LSBFIRST 0
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define DEC 10
+#define HEX 16
+#define PROGMEM
+#define F(text) text
+
+namespace host {
+/**
+ * @brief Cost of calls on Uno at 16 MHz, in nanoseconds (defaults are the Arduino core ones, measured)
+ */
+struct costs {
+    unsigned long mode{3000};      // pinMode
+    unsigned long write{3400};     // digitalWrite
+    unsigned long read{3200};      // digitalRead
+    unsigned long analog{112000};  // analogRead
+    unsigned long shift{500};      // shiftOut loop by bit, besides its three pin writes
+    unsigned long toggle{0};       // Extra by pin toggle
+    unsigned long delay{800};      // delay and delayMicroseconds call, besides time waited
+    unsigned long time{3600};      // micros and millis
+    unsigned long tone{14000};     // tone and noTone
+    unsigned long serial{5000};    // Serial byte, queued and sent by interrupt
+    unsigned long eeprom{2500};    // EEPROM byte read or write start
+};
+
+const short pins = 20;
+
+costs cost;
+
+unsigned long clock{};   // Microseconds
+unsigned long spare{};   // Nanoseconds below a microsecond
+unsigned long state{1};  // Random generator state
+
+byte modes[pins]{};
+byte written[pins]{};
+byte inputs[pins]{};  // Level of a released pin, as driven by outside (buttons, pull-ups)
+byte levels[pins]{};
+unsigned long toggles[pins]{};
+
+short analogs[pins]{};  // Raw analog readings
+
+FILE *output{};   // Where Serial writes go (discarded when null)
+int port{-1};     // Descriptor Serial reads and writes, as a pseudo-terminal or socket (none when negative)
+bool hung{};      // Other end of port closed
+FILE *capture{};  // Where pin changes are logged as CSV (none when null)
+unsigned long watched{};  // Pins logged, a bit by pin
+
+void (*listener)(byte pin){};  // Called when a pin toggles, so tools can model devices answering on lines (see drive)
+
+const unsigned short reach = 16384;  // Bytes of host stack painted, as free RAM (sanitizers make frames larger)
+
+byte *ground{};  // Lowest painted address of host stack
+
+/**
+ * @brief Charge time of a call
+ *
+ * @param nanoseconds Cost
+ */
+void charge(unsigned long nanoseconds) {
+    spare += nanoseconds;
+    clock += spare / 1000;
+    spare %= 1000;
+}
+
+/**
+ * @brief Log levels of watched pins as a CSV row
+ */
+void log() {
+    fprintf(capture, "%lu.%06lu", clock / 1000000, clock % 1000000);
+
+    for (short pin = 0; pin < pins; pin++) {
+        if (watched & (1ul << pin)) {
+            fprintf(capture, ",%d", levels[pin]);
+        }
+    }
+
+    fputc('\n', capture);
+}
+
+/**
+ * @brief Start logging pin levels, header names channels in order of pins
+ *
+ * @param file File to write
+ * @param mask Pins to log, a bit by pin
+ */
+void watch(FILE *file, unsigned long mask) {
+    capture = file;
+    watched = mask;
+
+    fprintf(capture, "Time [s]");
+
+    for (short pin = 0; pin < pins; pin++) {
+        if (watched & (1ul << pin)) {
+            fprintf(capture, ",D%d", pin);
+        }
+    }
+
+    fputc('\n', capture);
+
+    log();
+}
+
+/**
+ * @brief Update level of a pin from its mode, counting and logging toggles
+ *
+ * @param pin Pin
+ */
+void settle(byte pin) {
+    byte level = modes[pin] == OUTPUT ? written[pin] : inputs[pin];
+
+    if (level == levels[pin]) {
+        return;
+    }
+
+    levels[pin] = level;
+    toggles[pin]++;
+
+    charge(cost.toggle);
+
+    if (capture and (watched & (1ul << pin))) {
+        log();
+    }
+
+    if (listener) {
+        listener(pin);
+    }
+}
+
+/**
+ * @brief Drive a released pin from outside
+ *
+ * @param pin Pin
+ * @param level Level
+ */
+void drive(byte pin, byte level) {
+    inputs[pin] = level;
+    settle(pin);
+}
+
+/**
+ * @brief Total toggles in all pins
+ *
+ * @return Toggles
+ */
+unsigned long flips() {
+    unsigned long count = 0;
+
+    for (unsigned long value : toggles) {
+        count += value;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Make every call free, so time passes only when set
+ */
+void freeze() {
+    cost = costs();
+
+    cost.mode = 0;
+    cost.write = 0;
+    cost.read = 0;
+    cost.analog = 0;
+    cost.shift = 0;
+    cost.toggle = 0;
+    cost.delay = 0;
+    cost.time = 0;
+    cost.tone = 0;
+    cost.serial = 0;
+    cost.eeprom = 0;
+}
+
+/**
+ * @brief Host stack top in caller, as stack pointer on Uno
+ *
+ * @return Address
+ */
+__attribute__((noinline)) byte *stack() {  //
+    return static_cast<byte *>(__builtin_frame_address(0));
+}
+
+/**
+ * @brief Paint host stack below caller, which is never checked by sanitizers as frames are not there yet
+ *
+ * @param value Value painted
+ */
+__attribute__((noinline, no_sanitize_address)) void paint(byte value) {
+    volatile byte *top = stack() - 256;  // Kept clear of red zone of caller
+
+    ground = const_cast<byte *>(top) - reach;
+
+    for (volatile byte *address = ground; address < top; address++) {
+        *address = value;
+    }
+}
+
+/**
+ * @brief Painted bytes of host stack never reached since painting
+ *
+ * @param value Value painted
+ * @return Bytes
+ */
+__attribute__((noinline, no_sanitize_address)) unsigned short unused(byte value) {
+    volatile byte *top = stack();
+    volatile byte *address = ground;
+
+    while (address < top and *address == value) {
+        address++;
+    }
+
+    return address - ground;
+}
+
+/**
+ * @brief Change a cost from a setting as name=nanoseconds
+ *
+ * @param setting Setting
+ * @return If setting was known
+ */
+bool configure(const char *setting) {
+    struct entry {
+        const char *name;
+        unsigned long *value;
+    };
+
+    entry entries[] = {{"mode", &cost.mode},     {"write", &cost.write},   {"read", &cost.read},
+                       {"analog", &cost.analog}, {"shift", &cost.shift},   {"toggle", &cost.toggle},
+                       {"delay", &cost.delay},   {"time", &cost.time},     {"tone", &cost.tone},
+                       {"serial", &cost.serial}, {"eeprom", &cost.eeprom}};
+
+    const char *equal = strchr(setting, '=');
+
+    for (entry &item : entries) {
+        if (equal and size_t(equal - setting) == strlen(item.name) and strncmp(setting, item.name, equal - setting) == 0) {
+            *item.value = strtoul(equal + 1, nullptr, 10);
+            return true;
+        }
+    }
+
+    return false;
+}
+}  // namespace host
+
+template <class first, class second>
+auto min(first one, second other) -> typename std::decay<decltype(one < other ? one : other)>::type {  //
+    return one < other ? one : other;
+}
+
+template <class first, class second>
+auto max(first one, second other) -> typename std::decay<decltype(one < other ? one : other)>::type {  //
+    return one > other ? one : other;
+}
+
+inline byte pgm_read_byte(const void *address) {  //
+    return *static_cast<const byte *>(address);
+}
+
+inline unsigned short pgm_read_word(const void *address) {  //
+    return *static_cast<const unsigned short *>(address);
+}
+
+inline const void *pgm_read_ptr(const void *address) {  //
+    return *static_cast<const void *const *>(address);
+}
+
+inline void *memcpy_P(void *destination, const void *source, size_t length) {  //
+    return memcpy(destination, source, length);
+}
+
+inline void interrupts() {}
+inline void noInterrupts() {}
+
+inline void pinMode(byte pin, byte mode) {
+    host::charge(host::cost.mode);
+
+    host::modes[pin] = mode == OUTPUT ? OUTPUT : INPUT;
+    host::settle(pin);
+}
+
+inline void digitalWrite(byte pin, byte level) {
+    host::charge(host::cost.write);
+
+    host::written[pin] = level != LOW;
+    host::settle(pin);
+}
+
+inline int digitalRead(byte pin) {
+    host::charge(host::cost.read);
+
+    return host::levels[pin];
+}
+
+inline int analogRead(byte pin) {
+    host::charge(host::cost.analog);
+
+    return host::analogs[pin < A0 ? pin + A0 : pin];
+}
+
+inline void shiftOut(byte data, byte clock, byte order, byte value) {
+    for (byte bit = 0; bit < 8; bit++) {
+        host::charge(host::cost.shift);
+
+        digitalWrite(data, order == MSBFIRST ? value & (0x80 >> bit) : value & (1 << bit));
+        digitalWrite(clock, HIGH);
+        digitalWrite(clock, LOW);
+    }
+}
+
+inline void tone(byte, unsigned int, unsigned long = 0) {  //
+    host::charge(host::cost.tone);
+}
+
+inline void noTone(byte) {  //
+    host::charge(host::cost.tone);
+}
+
+inline unsigned long micros() {
+    host::charge(host::cost.time);
+
+    return host::clock;
+}
+
+inline unsigned long millis() {
+    host::charge(host::cost.time);
+
+    return host::clock / 1000;
+}
+
+inline void delayMicroseconds(unsigned int time) {  //
+    host::charge(host::cost.delay + 1000ul * time);
+}
+
+inline void delay(unsigned long time) {  //
+    host::charge(host::cost.delay + 1000000ul * time);
+}
+
+inline void randomSeed(unsigned long seed) {  //
+    host::state = seed ? seed : 1;
+}
+
+inline long random(long maximum) {
+    host::state = host::state * 1103515245ul + 12345ul;
+
+    return maximum > 0 ? long((host::state >> 16) & 0x7FFF) % maximum : 0;
+}
+
+inline long random(long minimum, long maximum) {  //
+    return maximum > minimum ? minimum + random(maximum - minimum) : minimum;
+}
+
+inline long map(long value, long low, long high, long inferior, long superior) {  //
+    return (value - low) * (superior - inferior) / (high - low) + inferior;
+}
+
+/**
+ * @class serial
+ * @brief Serial port, writes go to host::output and to host::port, and bytes are received from host::port
+ *
+ * Received bytes wait in a buffer as large as the one of Arduino core, filled without blocking when polled.
+ */
+struct serial {
+    byte received[64];
+    short head{};
+    short count{};
+
+    void begin(unsigned long) {}
+    void flush() {}
+
+    int available() {
+        if (host::port < 0 or host::hung or count == sizeof(received)) {
+            return count;
+        }
+
+        pollfd item{host::port, POLLIN, 0};
+
+        if (poll(&item, 1, 0) <= 0) {
+            return count;
+        }
+
+        short tail = (head + count) % sizeof(received);
+        short room = min(sizeof(received) - count, sizeof(received) - tail);
+
+        ssize_t length = ::read(host::port, received + tail, room);
+
+        if (length <= 0) {
+            host::hung = true;
+            return count;
+        }
+
+        count += length;
+
+        return count;
+    }
+
+    int read() {
+        if (not available()) {
+            return -1;
+        }
+
+        byte data = received[head];
+
+        head = (head + 1) % sizeof(received);
+        count--;
+
+        return data;
+    }
+
+    int availableForWrite() {  //
+        return 63;
+    }
+
+    size_t write(byte data) {
+        host::charge(host::cost.serial);
+
+        if (host::output) {
+            fputc(data, host::output);
+        }
+
+        if (host::port >= 0 and not host::hung and ::write(host::port, &data, 1) != 1) {
+            host::hung = true;
+        }
+
+        return 1;
+    }
+
+    size_t write(const byte *data, size_t length) {
+        for (size_t index = 0; index < length; index++) {
+            write(data[index]);
+        }
+
+        return length;
+    }
+
+    size_t print(const char *text) {
+        size_t length = strlen(text);
+
+        write(reinterpret_cast<const byte *>(text), length);
+
+        return length;
+    }
+
+    size_t print(char character) {  //
+        return write(character);
+    }
+
+    template <class type>
+    size_t print(type value, int base = DEC) {
+        char text[24];
+
+        if (base == HEX) {
+            snprintf(text, sizeof(text), "%llX", static_cast<unsigned long long>(value));
+        } else if (std::is_signed<type>::value) {
+            snprintf(text, sizeof(text), "%lld", static_cast<long long>(value));
+        } else {
+            snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+        }
+
+        return print(static_cast<const char *>(text));
+    }
+
+    size_t println() {  //
+        return print("\r\n");
+    }
+
+    template <class type>
+    size_t println(type value) {  //
+        return print(value) + println();
+    }
+
+    template <class type>
+    size_t println(type value, int base) {  //
+        return print(value, base) + println();
+    }
+};
+
+serial Serial;
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * Link two boards playing pong in lockstep (see lockstep.hpp) in host, Serial of each one backed by a socket or a port
+ * (see host::port), and check that both simulate the same match over a scripted session
+ *
+ *     c++ -std=gnu++11 -fpermissive -O2 tools/link.cpp -o link
+ *     ./link [TICKS] [port=PATH]
+ *
+ * Without a port, two processes are forked and joined by a socket pair. With a port (a pseudo-terminal made by socat,
+ * a serial port, or one relayed by tools/bridge), a single board plays on it, so two runs link with each other or
+ * with a board, and frames are paced in real time as on a board. Each board turns its knob back and forth at a pace
+ * drawn from its seed, and level goes through all of them, until TICKS ticks (2000 by default) are confirmed in both
+ * boards or the other end hangs up.
+ *
+ * A JSON line by board reports side, frames played, ticks confirmed, stalls, rollbacks, desyncs and losses. Exit
+ * status is 1 when a board never joined, confirmed fewer ticks, or saw a desync.
+ */
+#define THINGS_LOCKSTEP 1
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <termios.h>
+
+#include "host.hpp"
+
+#include "../games.hpp"
+
+/**
+ * @brief Open a port in raw mode at 115200 baud
+ *
+ * @param path Port path
+ * @return File descriptor (-1 on failure)
+ */
+int attach(const char *path) {
+    int port = open(path, O_RDWR | O_NOCTTY);
+
+    if (port < 0) {
+        return -1;
+    }
+
+    termios settings;
+
+    if (tcgetattr(port, &settings) == 0) {
+        cfmakeraw(&settings);
+        cfsetispeed(&settings, B115200);
+        cfsetospeed(&settings, B115200);
+
+        tcsetattr(port, TCSANOW, &settings);
+    }
+
+    return port;
+}
+
+/**
+ * @brief Knob position in script, turned back and forth end to end
+ *
+ * @param frame Frame
+ * @param span Frames to turn knob end to end
+ * @return Raw value
+ */
+short script(unsigned long frame, unsigned long span) {
+    unsigned long phase = frame % (2 * span);
+
+    return (phase < span ? phase : 2 * span - phase) * 1023 / span;
+}
+
+/**
+ * @brief Play linked pong on host::port until ticks are confirmed in both boards, and report link counters
+ *
+ * @param ticks Ticks to confirm
+ * @param seed Random seed of board, so boards draw other nonces and scripts
+ * @param paced Frames take a period of real time, as on a board
+ * @return Board joined, confirmed ticks and saw no desync
+ */
+bool play(unsigned short ticks, unsigned long seed, bool paced) {
+    games::descriptor game = games::get(0);
+
+    randomSeed(seed);
+
+    game.start();
+
+    const unsigned long span = numerics::rand(40, 160);
+    const unsigned long limit = 100ul * ticks + 1000;
+
+    unsigned long frame = 0;
+
+    for (; frame < limit and not host::hung; frame++) {
+        if (lockstep::joined and lockstep::confirmed >= ticks and lockstep::acked >= ticks) {
+            break;
+        }
+
+        host::clock += 1000ul * things::period;
+        host::analogs[things::firstPin] = script(frame, span);
+
+        things::frame.clear();
+        things::shade.clear();
+
+        game.update(frame / 500 % 4);
+
+        if (paced) {
+            usleep(1000ul * things::period);
+        }
+    }
+
+    printf("{\"side\":%d,\"frames\":%lu,\"ticks\":%u,\"stalls\":%lu,\"rollbacks\":%lu,\"desyncs\":%lu,\"losses\":%lu}\n",
+           lockstep::side, frame, lockstep::confirmed, lockstep::stalls, lockstep::rollbacks, lockstep::desyncs,
+           lockstep::losses);
+
+    fflush(stdout);
+
+    return lockstep::joined and lockstep::confirmed >= ticks and not lockstep::desyncs;
+}
+
+int main(int argc, char **argv) {
+    unsigned long ticks = 2000;
+    const char *path = nullptr;
+
+    for (int index = 1; index < argc; index++) {
+        if (strncmp(argv[index], "port=", 5) == 0) {
+            path = argv[index] + 5;
+        } else {
+            ticks = strtoul(argv[index], nullptr, 10);
+        }
+    }
+
+    ticks = min(ticks, 60000ul);  // Ticks are 16 bits in link
+
+    signal(SIGPIPE, SIG_IGN);
+
+    if (path) {
+        host::port = attach(path);
+
+        if (host::port < 0) {
+            perror(path);
+            return 2;
+        }
+
+        return play(ticks, getpid(), true) ? 0 : 1;
+    }
+
+    int ends[2];
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) < 0) {
+        perror("socketpair");
+        return 2;
+    }
+
+    fflush(stdout);
+
+    for (short board = 0; board < 2; board++) {
+        pid_t child = fork();
+
+        if (child < 0) {
+            perror("fork");
+            return 2;
+        }
+
+        if (child == 0) {
+            close(ends[1 - board]);
+
+            host::port = ends[board];
+
+            exit(play(ticks, board + 1, false) ? 0 : 1);
+        }
+    }
+
+    close(ends[0]);
+    close(ends[1]);
+
+    bool failed = false;
+
+    for (short board = 0; board < 2; board++) {
+        int status;
+
+        wait(&status);
+
+        failed = failed or not WIFEXITED(status) or WEXITSTATUS(status) != 0;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,609 @@
+#include "../geometry.hpp"
+#include "../things.hpp"
+#include "../trace.hpp"
+#include "../utils.hpp"
+
+#ifndef REFERENCE_HPP
+#define REFERENCE_HPP
+
+namespace reference {
+/**
+ * Frozen copies of game logic, checked against rewrites of tetris, snake and geometry::orthos (see
+ * tools/equivalence.cpp), so these are never edited. Rules are the ones of baseline 2e568e8: orthos, tetris collision
+ * (a board lookup by part) and snake food placement (a scan of body by draw) are as shipped there, before 49766f1
+ * turned the last two into row bitmasks. Later changes of behavior asked for on purpose are kept, so outputs compare:
+ * screen size, ghost block and shaded tail, BCD counters, queued turns, sounds and trace marks. Automatic players are
+ * left out, as streams are recorded from current ones.
+ */
+
+/**
+ * @brief Rotate a point around other point by an orthogonal angle
+ *
+ * @param other Point to rotate
+ * @param center Point in rotation center
+ * @param angle Angle to rotate
+ * @return Point rotated
+ */
+geometry::point orthos(const geometry::point &other, const geometry::point &center, int angle) {
+    angle = (abs(angle) % 4);
+
+    int osin[4] = {0, 1, 0, -1};
+    int ocos[4] = {1, 0, -1, 0};
+
+    double abscissa = other.get(false);
+    double ordered = other.get(true);
+
+    double horizontal = center.get(false);
+    double vertical = center.get(true);
+
+    double line = (abscissa - horizontal) * osin[angle] + (ordered - vertical) * ocos[angle] + vertical;
+    double column = (abscissa - horizontal) * ocos[angle] - (ordered - vertical) * osin[angle] + horizontal;
+
+    return geometry::point(line, column);
+}
+
+/**
+ * @brief Rotate a object around a point by an orthogonal angle
+ *
+ * @param other Object to rotate
+ * @param center Point in rotation center
+ * @param angle Angle to rotate
+ * @return Object rotated
+ */
+template <const short size>
+geometry::object<size> orthos(const geometry::object<size> &other, const geometry::point &center, double angle) {
+    geometry::object<size> rotated{other};
+
+    for (int index = 0; index < size; index++) {
+        rotated[index] = reference::orthos(other[index], center, angle);
+    }
+
+    return rotated;
+}
+
+namespace tetris {
+canvas::frame<things::width, things::height> frame;
+
+geometry::object<4> block;
+
+short position{};
+short rotation{};
+short level{};
+
+short steps{};
+short count{};
+short piece{};
+canvas::counter<4> score;
+
+bool change{};
+bool press{};
+
+short rotate[2]{};
+
+void start();
+void generate();
+void read();
+void draw();
+bool collision();
+void repos();
+bool verify();
+unsigned short result();
+void update(int);
+
+const devices::note clear[] PROGMEM = {{523, 50}, {659, 50}, {784, 50}, {1047, 100}, {0, 0}};
+
+/**
+ * @brief Start game
+ */
+void start() {
+    numerics::seed();
+
+    frame.clear();
+
+    change = true;
+}
+
+/**
+ * @brief Generate pieces
+ */
+void generate() {
+    const static short lines[7][4] = {{0, 0, 0, 0}, {0, 0, 0, 1}, {0, 0, 0, 1}, {0, 0, 0, 1},
+                                      {0, 0, 1, 1}, {1, 0, 0, 1}, {0, 0, 1, 1}};
+
+    const static short columns[7][4] = {{-1, 0, 1, 2}, {-1, 0, 1, -1}, {-1, 0, 1, 0}, {-1, 0, 1, 1},
+                                        {-1, 0, 0, 1}, {-1, 0, 1, 0},  {-1, 0, -1, 0}};
+
+    block = geometry::object<4>(
+        {geometry::point(lines[piece][0], columns[piece][0]), geometry::point(lines[piece][1], columns[piece][1]),
+         geometry::point(lines[piece][2], columns[piece][2]), geometry::point(lines[piece][3], columns[piece][3])});
+
+    block = reference::orthos(block, block[1], 4 - rotate[0]);
+}
+
+/**
+ * @brief Read peripherals state
+ */
+void read() {
+    press = bool(things::left.read() || things::right.read() || things::top.read() || things::bottom.read());
+
+    short current = things::first.read(0, things::width - 1);
+
+    short inferior = 0;
+    short superior = things::width - 1;
+
+    for (auto &part : block) {
+        short edges[2][2] = {{0, things::width - 1}, {things::width - 1, 0}};
+
+        short line = part.get(true);
+        short column = part.get(false);
+
+        for (short inferior = 0; inferior < column; inferior++) {
+            if (frame.get(line, inferior)) {
+                edges[0][0] = inferior + 1;
+            }
+        }
+
+        for (short superior = things::width - 1; superior > column; superior--) {
+            if (frame.get(line, superior)) {
+                edges[0][1] = superior - 1;
+            }
+        }
+
+        for (short index = 0; index < 4; index++) {
+            if (line == part.get(true)) {
+                edges[1][0] = min(edges[1][0], part.get(false));
+                edges[1][1] = max(edges[1][1], part.get(false));
+            }
+        }
+
+        inferior = max(inferior, position + edges[0][0] - edges[1][0]);
+        superior = min(superior, position + edges[0][1] - edges[1][1]);
+    }
+
+    position = current;
+
+    if (position < inferior) {
+        position = inferior;
+    }
+    if (position > superior) {
+        position = superior;
+    }
+
+    rotate[0] = things::second.read(0, 3);
+
+    if (rotate[0] == rotate[1]) {
+        rotation = 0;
+    } else {
+        rotation = (rotate[0] < rotate[1] ? 3 : 1);
+    }
+
+    rotate[1] = rotate[0];
+
+    if (change) {
+        piece = numerics::rand(0, 6);
+
+        generate();
+
+        short shift = 0;
+
+        for (auto &part : block) {
+            shift = max(shift, part.get(true));
+        }
+
+        block.translate(-shift - 1, 0);
+
+        change = false;
+    }
+
+    steps = 20 - 4 * level;
+    count = 1 + count % steps;
+}
+
+/**
+ * @brief Draw game in screen and display
+ */
+void draw() {
+    geometry::object<4> piece{block};
+
+    while (not collision()) {
+        block.translate(1, 0);
+    }
+
+    for (auto &part : block) {
+        things::shade.set(part, 1);
+    }
+
+    block = piece;
+
+    things::frame.set(block, true);
+
+    for (short index = 0; index < things::height; index++) {
+        things::frame[index] |= frame[index];
+    }
+
+    score.write(things::layer, 0);
+}
+
+/**
+ * @brief Verify collision
+ *
+ * @return Collision
+ */
+bool collision() {
+    for (auto &part : block) {
+        short line = part.get(true);
+        short column = part.get(false);
+
+        if (line == things::height - 1) {
+            return true;
+        }
+        if (frame.get(line + 1, column)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Update positions
+ */
+void repos() {
+    short shift = position - block[1].get(false);
+
+    block.translate(0, shift);
+
+    if (count == steps) {
+        if (collision()) {
+            frame.set(block, true);
+
+            for (short position = 0; position < things::height; position++) {
+                if (frame[position] == frame.full()) {
+                    for (short index = position; index > 0; index--) {
+                        frame[index] = frame[index - 1];
+                    }
+
+                    ++score;
+
+                    trace::mark(trace::line);
+
+                    things::buzzer.play(clear);
+
+                    frame[0] = 0;
+                }
+            }
+
+            change = true;
+            return;
+        }
+
+        block.translate(1, 0);
+    }
+
+    block = reference::orthos(block, block[1], rotation);
+
+    if (press) {
+        while (not collision()) {
+            block.translate(1, 0);
+        }
+
+        press = false;
+    }
+
+    things::frame.set(block, true);
+}
+
+/**
+ * @brief Verify defeat
+ *
+ * @return Defeat
+ */
+bool verify() {
+    if (count == steps) {
+        if (collision()) {
+            for (auto &part : block) {
+                short line = part.get(true);
+
+                if (line < 0) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Score of game
+ *
+ * @return Cleared lines, in BCD
+ */
+unsigned short result() {  //
+    return score.get();
+}
+
+
+
+
+
+/**
+ * @brief Update game state
+ *
+ * @param value Game level
+ */
+void update(int value) {
+    level = value;
+
+    read();
+    repos();
+    draw();
+}
+}  // namespace tetris
+
+namespace snake {
+static const short size{things::width * things::height};
+static const short capacity{3};
+
+geometry::object<size> body;
+
+geometry::point food;
+geometry::point sense;
+
+geometry::point turns[capacity];  // Pending changes of sense, one applied by move
+short pending{};
+
+bool left{};
+bool right{};
+bool top{};
+bool bottom{};
+
+short level{};
+
+short steps{};
+short count{};
+
+short length{};
+canvas::counter<2> points;
+
+void start();
+void read();
+void turn(short, short);
+void draw();
+void repos();
+bool found();
+void change();
+bool verify();
+unsigned short result();
+void update(int);
+
+const devices::note eat[] PROGMEM = {{1319, 40}, {1760, 60}, {0, 0}};
+
+/**
+ * @brief Start game
+ */
+void start() {
+    read();
+    repos();
+
+    numerics::seed();
+
+    length = 1;
+    points = 1;
+
+    short line = numerics::rand(things::height / 2 - 1, things::height / 2);
+    short column = numerics::rand(things::width / 2 - 1, things::width / 2);
+
+    for (auto &part : body) {
+        part.set(line, column);
+    }
+
+    food.set(numerics::rand(0, things::height - 1), numerics::rand(0, things::width - 1));
+
+    sense.set(0, 0);
+
+    pending = 0;
+}
+
+/**
+ * @brief Read peripherals state
+ */
+void read() {
+    left = things::left.read();
+    bottom = things::right.read();
+    top = things::top.read();
+    right = things::bottom.read();
+
+    if (left) {
+        turn(0, -1);
+    }
+    if (right) {
+        turn(0, 1);
+    }
+    if (top) {
+        turn(-1, 0);
+    }
+    if (bottom) {
+        turn(1, 0);
+    }
+
+    steps = 20 - 4 * level;
+    count = 1 + count % steps;
+}
+
+/**
+ * @brief Queue a change of sense, valid only across the last queued (or current) sense, or from a stop
+ *
+ * @param line Vertical sense
+ * @param column Horizontal sense
+ */
+void turn(short line, short column) {
+    if (pending == capacity) {
+        return;
+    }
+
+    geometry::point last{pending ? turns[pending - 1] : sense};
+
+    bool stopped = last.get(true) == 0 and last.get(false) == 0;
+    bool across = (line != 0) != (last.get(true) != 0);
+
+    if (not(stopped or across)) {
+        return;
+    }
+
+    turns[pending++].set(line, column);
+}
+
+/**
+ * @brief Draw game in screen and display
+ */
+void draw() {
+    short tail = length - length / 3;
+
+    for (short index = 0; index < length; index++) {
+        if (index < tail) {
+            things::frame.set(body[index], true);
+        } else {
+            things::shade.set(body[index], 2);
+        }
+    }
+
+    things::frame.set(food, true);
+
+    things::layer.set(0, -1);
+    points.write(things::layer, 1);
+    things::layer.set(3, -1);
+
+    things::display.separator(false);
+}
+
+/**
+ * @brief Verify defeat
+ *
+ * @return defeat
+ */
+bool verify() {
+    for (short index = 1; index < length; index++) {
+        if (body[0] == body[index]) {
+            return true;
+        }
+    }
+
+    short line = body[0].get(true);
+    short column = body[1].get(false);
+
+    if (line < 0 or line > things::height - 1) {
+        return true;
+    }
+    if (column < 0 or column > things::width - 1) {
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Collision snake in itself
+ *
+ * @return If collision
+ */
+bool found() {  //
+    return body[0] == food;
+}
+
+/**
+ * @brief Change food position
+ */
+void change() {
+    while (true) {
+        food.set(numerics::rand(0, things::height - 1), numerics::rand(0, things::width - 1));
+
+        bool valid = true;
+
+        for (auto &part : body) {
+            if (food == part) {
+                valid = false;
+
+                break;
+            }
+        }
+
+        if (valid) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Update positions
+ */
+void repos() {
+    if (count == steps) {
+        if (pending) {
+            sense = turns[0];
+
+            for (short index = 1; index < pending; index++) {
+                turns[index - 1] = turns[index];
+            }
+
+            pending--;
+        }
+
+        short index = length - 1;
+
+        while (index) {
+            body[index] = body[index - 1];
+
+            index--;
+        }
+
+        body[index].translate(sense);
+
+        if (found()) {
+            trace::begin(trace::food);
+            change();
+            trace::end(trace::food);
+
+            things::buzzer.play(eat);
+
+            length++;
+            ++points;
+        } else {
+            index = length;
+
+            while (index < size) {
+                body[index] = body[index - 1];
+
+                index++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Score of game
+ *
+ * @return Eaten foods, in BCD
+ */
+unsigned short result() {  //
+    return points.get();
+}
+
+
+
+/**
+ * @brief Update game state
+ *
+ * @param value Game level
+ */
+void update(int value) {
+    level = value;
+
+    read();
+    repos();
+    draw();
+}
+}  // namespace snake
+}  // namespace reference
+
+#endif
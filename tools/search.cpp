@@ -0,0 +1,144 @@
+/**
+ * Search tetris placements in host on all cores, over positions met by the automatic player
+ *
+ *     c++ -std=gnu++11 -fpermissive -O2 -pthread tools/search.cpp -o search
+ *     ./search [POSITIONS] [threads=THREADS]
+ *
+ * Positions (board and block each time the automatic player plans, 100000 by default) are collected playing tetris
+ * from a fixed seed, keeping the placement tetris::plan chose. Then they are searched again by tetris::search, first in
+ * one thread and then in THREADS threads (as many as cores by default), each thread taking every THREADS-th position,
+ * and every placement found is checked against the one chosen in game.
+ *
+ * A JSON line reports positions, threads, positions searched per second in one thread and in all of them, speedup and
+ * mismatches. Exit status is 1 when a placement differs.
+ */
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "host.hpp"
+
+#include "../games.hpp"
+
+/**
+ * @brief Position met by automatic player and placement chosen in game
+ */
+struct position {
+    tetris::board field;
+    geometry::object<4> shape;
+    short knob;
+    tetris::placement chosen;
+};
+
+/**
+ * @brief Play tetris by automatic player, collecting a position each time it plans
+ *
+ * @param count Positions collected
+ * @return Positions
+ */
+std::vector<position> collect(unsigned long count) {
+    std::vector<position> positions;
+
+    positions.reserve(count);
+
+    randomSeed(1);
+    host::freeze();
+
+    bool restart = true;
+
+    for (unsigned long tick = 0; positions.size() < count; tick++) {
+        host::clock = 1000ul * things::period * (tick + 1);
+
+        if (restart) {
+            tetris::start();
+        }
+
+        things::frame.clear();
+        things::shade.clear();
+        things::layer.clear();
+
+        bool planned = tetris::planned;
+
+        position item{tetris::frame, tetris::block, tetris::rotate[1], {}};
+
+        tetris::pilot();
+
+        if (tetris::planned and not planned) {
+            item.chosen = {tetris::goal, tetris::dial};
+
+            positions.push_back(item);
+        }
+
+        tetris::update(tick / 20000 % 4);
+
+        restart = tetris::verify();
+    }
+
+    return positions;
+}
+
+/**
+ * @brief Search positions in threads
+ *
+ * @param positions Positions
+ * @param threads Threads
+ * @param mismatches Placements that differ from the ones chosen in game
+ * @return Positions searched per second
+ */
+double run(const std::vector<position> &positions, unsigned threads, std::atomic<unsigned long> &mismatches) {
+    typedef std::chrono::steady_clock watch;
+
+    std::vector<std::thread> workers;
+
+    watch::time_point begin = watch::now();
+
+    for (unsigned worker = 0; worker < threads; worker++) {
+        workers.emplace_back([&positions, &mismatches, threads, worker]() {
+            unsigned long differ = 0;
+
+            for (size_t index = worker; index < positions.size(); index += threads) {
+                const position &item = positions[index];
+
+                tetris::placement found = tetris::search(item.field, item.shape, item.knob);
+
+                differ += found.column != item.chosen.column or found.rotation != item.chosen.rotation;
+            }
+
+            mismatches += differ;
+        });
+    }
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    double seconds = std::chrono::duration<double>(watch::now() - begin).count();
+
+    return positions.size() / max(seconds, 1e-9);
+}
+
+int main(int argc, char **argv) {
+    unsigned long count = 100000;
+    unsigned threads = max(std::thread::hardware_concurrency(), 1u);
+
+    for (int index = 1; index < argc; index++) {
+        if (strncmp(argv[index], "threads=", 8) == 0) {
+            threads = max(atoi(argv[index] + 8), 1);
+        } else {
+            count = strtoul(argv[index], nullptr, 10);
+        }
+    }
+
+    std::vector<position> positions = collect(count);
+
+    std::atomic<unsigned long> mismatches{0};
+
+    double single = run(positions, 1, mismatches);
+    double parallel = run(positions, threads, mismatches);
+
+    printf("{\"positions\":%lu,\"threads\":%u,\"single\":%.0f,\"parallel\":%.0f,\"speedup\":%.2f,\"mismatches\":%lu}\n",
+           count, threads, single, parallel, parallel / single, mismatches.load());
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+#include <cstdint>
+
+#ifndef SESSION_HPP
+#define SESSION_HPP
+
+namespace session {
+/**
+ * @brief Screen and display state rebuilt from telemetry packets
+ */
+struct state {
+    unsigned sequence{};    // Sequence of last packet
+    unsigned time{};        // Milliseconds since first packet
+    unsigned frames{};      // Frames since previous packet
+    unsigned size{1};       // Bytes by row
+    unsigned width{8};      // Columns, first one in bit width - 1 of rows
+    uint32_t rows[8]{};     // Rows with first column in most significant bit
+    int digits[4]{};        // Digits in display (-1 to blank)
+    bool synced{false};     // If a key packet was received
+};
+
+/**
+ * @class decoder
+ * @brief Decode telemetry packets (see telemetry.hpp) byte by byte
+ *
+ */
+class decoder {
+   private:
+    static const uint8_t sync = 0xA5;
+
+    uint8_t packet[64];
+    unsigned length{};
+    unsigned expected{};
+
+    unsigned last{};
+
+    state current;
+
+    /**
+     * @brief Amount of bytes in packet, once its header is read
+     *
+     * @return Packet length
+     */
+    unsigned measure() const {
+        uint8_t flags = packet[2];
+        uint8_t mask = packet[5];
+
+        unsigned size = (flags >> 4) & 7;
+        unsigned rows = 0;
+
+        for (unsigned index = 0; index < 8; index++) {
+            rows += (mask >> index) & 1;
+        }
+
+        return 7 + rows * size + (flags & 1 ? 4 : 0) + 1;
+    }
+
+    /**
+     * @brief Apply a complete packet to state
+     *
+     * @return If packet was valid
+     */
+    bool apply() {
+        uint8_t sum = 0;
+
+        for (unsigned index = 0; index + 1 < length; index++) {
+            sum += packet[index];
+        }
+
+        if (sum != packet[length - 1]) {
+            return false;
+        }
+
+        uint8_t flags = packet[2];
+        uint8_t mask = packet[5];
+
+        if (not current.synced and not(flags & 2)) {
+            return false;
+        }
+
+        unsigned time = packet[3] | (packet[4] << 8);
+
+        if (current.synced) {
+            current.time += (time - last) & 0xFFFF;
+            current.frames = (packet[1] - current.sequence) & 0xFF;
+        }
+
+        last = time;
+
+        current.synced = true;
+        current.sequence = packet[1];
+        current.size = (flags >> 4) & 7;
+        current.width = packet[6];
+
+        unsigned position = 7;
+
+        for (unsigned index = 0; index < 8; index++) {
+            if (mask & (1 << index)) {
+                uint32_t row = 0;
+
+                for (unsigned count = 0; count < current.size; count++) {
+                    row = (row << 8) | packet[position++];
+                }
+
+                current.rows[index] = row;
+            }
+        }
+
+        if (flags & 1) {
+            for (int &digit : current.digits) {
+                digit = int8_t(packet[position++]);
+            }
+        }
+
+        return true;
+    }
+
+   public:
+    /**
+     * @brief Feed a byte read from Serial
+     *
+     * @param data Byte
+     * @return If a frame was completed
+     */
+    bool feed(uint8_t data) {
+        if (length == 0 and data != sync) {
+            return false;
+        }
+
+        packet[length++] = data;
+
+        if (length == 7) {
+            expected = measure();
+
+            unsigned size = (packet[2] >> 4) & 7;
+
+            if (expected > sizeof(packet) or size == 0 or size > 4 or packet[6] == 0 or packet[6] > 8 * size) {
+                length = 0;
+            }
+
+            return false;
+        }
+
+        if (length < 7 or length < expected) {
+            return false;
+        }
+
+        bool valid = apply();
+
+        length = 0;
+
+        return valid;
+    }
+
+    /**
+     * @brief State after last decoded packet
+     *
+     * @return State
+     */
+    const state &get() const {  //
+        return current;
+    }
+};
+}  // namespace session
+
+#endif
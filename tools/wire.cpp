@@ -0,0 +1,274 @@
+/**
+ * Check screen and display drivers at bit level in host: each game is played by its automatic player while host logs
+ * screen and display pins as CSV (see host::watch), the capture is decoded as tools/bus does, and the rebuilt screen
+ * and digits are compared with the frame and layer rendered after each render
+ *
+ *     c++ -std=gnu++11 -fpermissive -O2 tools/wire.cpp -o wire
+ *     ./wire [TICKS] [capture=FILE]
+ *
+ * Each game is played TICKS ticks (2000 by default), going through levels, from a fixed seed. Capture is written to
+ * FILE when given, to be read again by tools/bus (channels are in order of pins). A JSON line by game reports ticks,
+ * bus transactions (screen latches and register writes, display frames and bytes) and mismatches, and exit status is
+ * 1 when any rendered pixel or digit differs from the rebuilt one.
+ */
+#include <unistd.h>
+
+#include "bus.hpp"
+#include "host.hpp"
+
+#include "../games.hpp"
+
+/**
+ * @brief Channel of a pin in capture, pins are logged in order
+ *
+ * @param mask Pins logged, a bit by pin
+ * @param pin Pin
+ * @return Channel
+ */
+unsigned channel(unsigned long mask, byte pin) {
+    unsigned count = 0;
+
+    for (byte other = 0; other < pin; other++) {
+        count += (mask >> other) & 1;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Answer display as TM1637 does, pulling data line low to acknowledge each byte, from 8th falling clock to 9th
+ *
+ * @param pin Pin toggled
+ */
+void acknowledge(byte pin) {
+    static bool clock = true;
+    static bool data = true;
+    static bool framed = false;
+    static unsigned rises = 0;
+
+    bool clk = host::levels[things::clockDisplayPin];
+    bool dio = host::levels[things::inputDisplayPin];
+
+    if (pin == things::inputDisplayPin and clk and clock and dio != data) {
+        framed = not dio;
+        rises = 0;
+    } else if (pin == things::clockDisplayPin and framed) {
+        if (clk) {
+            rises++;
+        } else if (rises == 8) {
+            host::drive(things::inputDisplayPin, LOW);
+        } else if (rises == 9) {
+            rises = 0;
+            host::drive(things::inputDisplayPin, HIGH);
+        }
+    }
+
+    clock = host::levels[things::clockDisplayPin];
+    data = host::levels[things::inputDisplayPin];
+}
+
+/**
+ * @class check
+ * @brief Decode capture as it grows and compare rebuilt devices with what was rendered
+ *
+ */
+class check {
+   private:
+    unsigned long mask;
+
+    bus::capture samples;
+
+   public:
+    bus::screen chain{things::modules};
+    bus::display digits;
+
+    unsigned long mismatches{};
+
+    /**
+     * @brief Initialize check
+     *
+     * @param file Capture, read as host writes it
+     * @param mask Pins logged, a bit by pin
+     */
+    check(FILE *file, unsigned long mask) : mask(mask), samples(file) {
+        chain.verbose = false;
+        digits.verbose = false;
+    }
+
+    /**
+     * @brief Feed samples logged since last call to decoders
+     */
+    void decode() {
+        fflush(host::capture);
+
+        while (samples.next()) {
+            chain.feed(samples.time, samples.level(channel(mask, things::inputScreenPin)),
+                       samples.level(channel(mask, things::clockScreenPin)),
+                       samples.level(channel(mask, things::loadScreenPin)));
+
+            digits.feed(samples.time, samples.level(channel(mask, things::inputDisplayPin)),
+                        samples.level(channel(mask, things::clockDisplayPin)));
+        }
+    }
+
+    /**
+     * @brief Compare rebuilt screen with a rendered frame
+     *
+     * @param image Frame rendered
+     * @param tick Tick, to report
+     */
+    void compare(const canvas::frame<things::width, things::height> &image, unsigned long tick) {
+        decode();
+
+        for (short line = 0; line < things::height; line++) {
+            for (short column = 0; column < things::width; column++) {
+                if (chain.lit(line, column) == image.get(line, column)) {
+                    continue;
+                }
+
+                if (not mismatches++) {
+                    fprintf(stderr, "tick %lu: screen pixel %d,%d is %d\n", tick, line, column, chain.lit(line, column));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Compare rebuilt digits with a rendered layer, separator aside
+     *
+     * @param segments Layer rendered
+     * @param tick Tick, to report
+     */
+    void compare(const canvas::layer &segments, unsigned long tick) {
+        decode();
+
+        for (short index = 0; index < 4; index++) {
+            byte expected = segments.get(index);  // Segments
+
+            if ((digits.digits[index] & 0x7F) == expected) {
+                continue;
+            }
+
+            if (not mismatches++) {
+                fprintf(stderr, "tick %lu: digit %d is %02X, not %02X\n", tick, index, digits.digits[index], expected);
+            }
+        }
+    }
+};
+
+int main(int argc, char **argv) {
+    unsigned long ticks = 2000;
+    const char *path = nullptr;
+
+    for (int index = 1; index < argc; index++) {
+        if (strncmp(argv[index], "capture=", 8) == 0) {
+            path = argv[index] + 8;
+        } else {
+            ticks = strtoul(argv[index], nullptr, 10);
+        }
+    }
+
+    char temporary[] = "/tmp/wireXXXXXX";
+
+    if (not path) {
+        int descriptor = mkstemp(temporary);
+
+        if (descriptor < 0) {
+            perror("mkstemp");
+            return 2;
+        }
+
+        close(descriptor);
+
+        path = temporary;
+    }
+
+    FILE *writer = fopen(path, "w");
+    FILE *reader = fopen(path, "r");
+
+    if (not writer or not reader) {
+        perror(path);
+        return 2;
+    }
+
+    if (path == temporary) {
+        unlink(path);
+    }
+
+    host::drive(things::inputDisplayPin, HIGH);  // Display lines are pulled up when released
+    host::drive(things::clockDisplayPin, HIGH);
+
+    host::listener = acknowledge;
+
+    const unsigned long mask = (1ul << things::inputScreenPin) | (1ul << things::clockScreenPin) |
+                               (1ul << things::loadScreenPin) | (1ul << things::inputDisplayPin) |
+                               (1ul << things::clockDisplayPin);
+
+    host::watch(writer, mask);
+
+    check wire(reader, mask);
+
+    const short slots = things::shade.slots();
+
+    bool failed = false;
+
+    for (short index = 0; index < games::count; index++) {
+        games::descriptor game = games::get(index);
+
+        unsigned long mismatches = wire.mismatches;
+        unsigned long latches = wire.chain.latches;
+        unsigned long writes = wire.chain.writes;
+        unsigned long frames = wire.digits.frames;
+        unsigned long written = wire.digits.written;
+        unsigned long nacks = wire.digits.nacks;
+
+        bool restart = true;
+
+        randomSeed(1);
+
+        for (unsigned long tick = 0; tick < ticks; tick++) {
+            host::clock += 1000ul * things::period;
+
+            if (restart) {
+                game.start();
+            }
+
+            things::frame.clear();
+            things::shade.clear();
+            things::layer.clear();
+
+            things::left.read();
+            things::right.read();
+            things::top.read();
+            things::bottom.read();
+
+            game.pilot();
+            game.update(tick / 500 % 4);
+
+            for (short slice = 0; slice < slots; slice++) {
+                canvas::frame<things::width, things::height> image = things::frame;
+
+                image |= things::shade.slice(slice);
+
+                things::screen.render(image);
+                wire.compare(image, tick);
+            }
+
+            things::display.render(things::layer);
+            wire.compare(things::layer, tick);
+
+            restart = game.verify();
+        }
+
+        printf("{\"game\":%d,\"ticks\":%lu,\"screen\":[%lu,%lu],\"display\":[%lu,%lu,%lu],\"mismatches\":%lu}\n",
+               index, ticks, wire.chain.latches - latches, wire.chain.writes - writes, wire.digits.frames - frames,
+               wire.digits.written - written, wire.digits.nacks - nacks, wire.mismatches - mismatches);
+
+        failed = failed or wire.mismatches != mismatches;
+    }
+
+    fclose(writer);
+    fclose(reader);
+
+    return failed ? 1 : 0;
+}
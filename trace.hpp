@@ -0,0 +1,191 @@
+#include "things.hpp"
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+namespace trace {
+/**
+ * Events are recorded in a ring and drained over Serial by a task, as many as
+ * fit in Serial transmission buffer, in chunks of:
+ *
+ *     sync (2 bytes), count, lost, events (4 bytes each: time, id, kind)
+ *
+ * Events arriving with ring full are dropped and counted as lost in next chunk.
+ *
+ * Time is in units of 4 microseconds (16 bits, little endian), so it wraps every 262 ms.
+ * Identifiers below 32 are scheduler tasks, in order of engine::tasks.
+ *
+ * After boot, before events, each identifier is named once, a name by chunk of:
+ *
+ *     sync (2 bytes), id, length, characters
+ */
+const byte begun = 'B';
+const byte ended = 'E';
+const byte instant = 'i';
+
+const byte defeat = 32;
+const byte food = 33;
+const byte line = 34;
+const byte hit = 35;
+const byte kill = 36;
+
+const char names[] PROGMEM = "defeat\0food\0line\0hit\0kill\0";  // Game events from 32, ended by an empty name
+
+const byte capacity = 32;  // Power of two
+
+struct event {
+    unsigned short time;
+    byte id;
+    byte kind;
+};
+
+event events[capacity];
+
+byte head{};
+byte tail{};
+byte lost{};
+byte named{};  // Next identifier to name (255 when all were named)
+
+/**
+ * @brief Record an event, dropping it when buffer is full
+ *
+ * @param id Identifier
+ * @param kind Kind of event
+ */
+void record(byte id, byte kind) {
+    if (not things::trace) {
+        return;
+    }
+
+    if (byte(head - tail) == capacity) {
+        lost += lost < 255;
+        return;
+    }
+
+    event &item = events[head++ % capacity];
+
+    item.time = micros() >> 2;
+    item.id = id;
+    item.kind = kind;
+}
+
+/**
+ * @brief Record begin of a span
+ *
+ * @param id Identifier
+ */
+void begin(byte id) {  //
+    record(id, begun);
+}
+
+/**
+ * @brief Record end of a span
+ *
+ * @param id Identifier
+ */
+void end(byte id) {  //
+    record(id, ended);
+}
+
+/**
+ * @brief Record an instant event
+ *
+ * @param id Identifier
+ */
+void mark(byte id) {  //
+    record(id, instant);
+}
+
+/**
+ * @brief Find a name in flash
+ *
+ * @param list Null terminated names, ended by an empty one
+ * @param index Position of name
+ * @return Name (empty when past the end)
+ */
+const char *find(const char *list, byte index) {
+    while (index and pgm_read_byte(list)) {
+        while (pgm_read_byte(list++)) {
+        }
+
+        index--;
+    }
+
+    return list;
+}
+
+/**
+ * @brief Send name of next identifier over Serial, if it fits
+ *
+ * @param tasks Names of scheduler tasks, null terminated and ended by an empty one
+ * @param space Bytes free in Serial transmission buffer
+ */
+void announce(const char *tasks, short space) {
+    const char *text = named < 32 ? find(tasks, named) : find(names, named - 32);
+
+    byte length = 0;
+
+    while (pgm_read_byte(text + length)) {
+        length++;
+    }
+
+    if (length == 0) {
+        named = named < 32 ? 32 : 255;
+        return;
+    }
+
+    if (space < length + 4) {
+        return;
+    }
+
+    Serial.write(0x5A);
+    Serial.write('N');
+    Serial.write(named++);
+    Serial.write(length);
+
+    while (length--) {
+        Serial.write(pgm_read_byte(text++));
+    }
+}
+
+/**
+ * @brief Drain recorded events over Serial without waiting for it, after naming identifiers
+ *
+ * @param tasks Names of scheduler tasks, null terminated and ended by an empty one
+ */
+void dump(const char *tasks) {
+    if (not things::trace) {
+        return;
+    }
+
+    if (named < 255) {
+        announce(tasks, Serial.availableForWrite());
+        return;
+    }
+
+    short space = Serial.availableForWrite() - 4;
+
+    if (space < short(sizeof(event))) {
+        return;
+    }
+
+    byte count = min(byte(head - tail), byte(space / sizeof(event)));
+
+    if (count == 0 and lost == 0) {
+        return;
+    }
+
+    Serial.write(0x5A);
+    Serial.write('T');
+    Serial.write(count);
+    Serial.write(lost);
+
+    while (count--) {
+        Serial.write(reinterpret_cast<const byte *>(&events[tail++ % capacity]), sizeof(event));
+    }
+
+    lost = 0;
+}
+}  // namespace trace
+
+#endif
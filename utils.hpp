@@ -72,6 +72,44 @@ byte set(byte number, byte position, bool value) {
     return number;
 }
 
+/**
+ * @brief Count bits set in an integer number
+ *
+ * @param number Number to count bits
+ * @return Amount of bits set
+ */
+byte ones(unsigned long number) {
+    byte count = 0;
+
+    while (number) {
+        number &= number - 1;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Compute CRC-8 (polynomial 0x31) of a bytes array
+ *
+ * @param data Bytes array
+ * @param length Amount of bytes
+ * @return CRC
+ */
+byte crc(const byte *data, short length) {
+    byte value = 0xFF;
+
+    while (length--) {
+        value ^= *data++;
+
+        for (byte bit = 0; bit < 8; bit++) {
+            value = (value & 0x80) ? (value << 1) ^ 0x31 : (value << 1);
+        }
+    }
+
+    return value;
+}
+
 /**
  * @brief Encode a number
  *